@@ -0,0 +1,98 @@
+/*
+ * Compare the per-sprite path (one Texture::Clear per sprite) with the atlas and sprite batch.
+ * Frames are drawn by the software renderer into a surface, so no window or GPU is needed.
+ */
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <SDL.h>
+#include <texture.h>
+#include <atlas.h>
+#include <spritebatch.h>
+#include "fixture.h"
+
+//The number of different sprite images.
+static const int Kinds = 64;
+//The size of every sprite image.
+static const int SpriteSize = 32;
+
+/*
+ * \brief Write the sprite images into BMP files, each filled with its own color.
+ * \return A vector containing the paths of the images.
+ */
+static std::vector<std::string> WriteSprites()
+{
+	std::vector<std::string> files;
+	for (int i = 0; i < Kinds; i++)
+	{
+		files.push_back("bench_sprite_" + std::to_string(i) + ".bmp");
+		WriteImage(files.back(), SpriteSize, { (Uint8)(i * 4),(Uint8)(255 - i * 4),(Uint8)(i * 16),255 });
+	}
+	return files;
+}
+
+/*
+ * \brief Get the destination of a sprite, spread over a 1024 * 768 frame.
+ */
+static SDL_Point Place(int i)
+{
+	return { (i * 37) % (1024 - SpriteSize),(i * 53) % (768 - SpriteSize) };
+}
+
+//Draw every sprite with its own texture.
+static void BM_PerSpriteTexture(benchmark::State& state)
+{
+	int number = (int)state.range(0);
+	std::vector<std::string> files = WriteSprites();
+	Screen screen(1024, 768);
+	SDL_Renderer* renderer = screen.renderer;
+	std::vector<Texture> textures(Kinds);
+	for (int i = 0; i < Kinds; i++)
+		textures[i].CreateFromImage(renderer, files[i].c_str());
+	for (auto _ : state)
+	{
+		SDL_RenderClear(renderer);
+		for (int i = 0; i < number; i++)
+			textures[i % Kinds].Clear(Place(i));
+		SDL_RenderPresent(renderer);
+	}
+	state.counters["draw_calls"] = number;
+	state.counters["frames/s"] = benchmark::Counter((double)state.iterations(), benchmark::Counter::kIsRate);
+	for (int i = 0; i < Kinds; i++)
+		textures[i].free();
+	RemoveImages(files);
+}
+BENCHMARK(BM_PerSpriteTexture)->Arg(100)->Arg(1000)->Arg(5000)->Unit(benchmark::kMicrosecond);
+
+//Draw every sprite from an atlas through the sprite batch.
+static void BM_SpriteBatch(benchmark::State& state)
+{
+	int number = (int)state.range(0);
+	std::vector<std::string> files = WriteSprites();
+	Screen screen(1024, 768);
+	SDL_Renderer* renderer = screen.renderer;
+	Atlas atlas;
+	atlas.Init(renderer, 1024);
+	std::vector<int> ids;
+	for (int i = 0; i < Kinds; i++)
+		ids.push_back(atlas.AddImage(files[i].c_str()));
+	atlas.Build();
+	SpriteBatch batch;
+	int calls = 0;
+	for (auto _ : state)
+	{
+		SDL_RenderClear(renderer);
+		batch.Begin(renderer, atlas);
+		for (int i = 0; i < number; i++)
+			batch.Clear(ids[i % Kinds], Place(i));
+		calls = batch.End();
+		SDL_RenderPresent(renderer);
+	}
+	state.counters["draw_calls"] = calls;
+	state.counters["pages"] = atlas.PageCount();
+	state.counters["frames/s"] = benchmark::Counter((double)state.iterations(), benchmark::Counter::kIsRate);
+	batch.free();
+	atlas.free();
+	RemoveImages(files);
+}
+BENCHMARK(BM_SpriteBatch)->Arg(100)->Arg(1000)->Arg(5000)->Unit(benchmark::kMicrosecond);
\ No newline at end of file
@@ -0,0 +1,114 @@
+/*
+ * Measure the BoxSet kernels testing a rectangle against many boxes, after checking
+ * every kernel against the scalar one on random boxes.
+ */
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <SDL.h>
+#include <collision.h>
+#include <boxset.h>
+
+/*
+ * \brief Make random boxes with a fixed seed, so that every run tests the same boxes.
+ * \param count The number of boxes.
+ * \param seed The seed of the random numbers.
+ * \return A vector containing the boxes.
+ */
+static std::vector<SDL_Rect> RandomBoxes(int count, Uint32 seed)
+{
+	std::vector<SDL_Rect> boxes;
+	for (int i = 0; i < count; i++)
+	{
+		SDL_Rect box;
+		int* fields[4] = { &box.x,&box.y,&box.w,&box.h };
+		for (int k = 0; k < 4; k++)
+		{
+			seed = seed * 1664525 + 1013904223;
+			*fields[k] = k < 2 ? (int)(seed >> 8) % 256 - 64 : (int)(seed >> 8) % 64;
+		}
+		boxes.push_back(box);
+	}
+	return boxes;
+}
+
+/*
+ * \brief Compare the masks of a kernel with the ones of the scalar kernel, on sets whose sizes leave every possible tail
+ * in the last block, and on rectangles touching, containing and inside the boxes.
+ * \param kernel The kernel.
+ * \return 1 if the kernel agrees with the scalar one, or 0 if not.
+ */
+static bool MatchesScalar(int kernel)
+{
+	int previous = BoxSet::GetKernel();
+	bool matched = 1;
+	for (int count = 0; count <= BoxSet::Block * 3 + 1 && matched; count++)
+	{
+		BoxSet set(RandomBoxes(count, count + 1));
+		std::vector<SDL_Rect> rects = RandomBoxes(64, count + 1000);
+		for (int i = 0; i < count; i++)
+			rects.push_back(set.Get(i));
+		for (int i = 0; i < rects.size() && matched; i++)
+		{
+			for (int first = 0; first < set.Size(); first += BoxSet::Block)
+			{
+				BoxSet::SetKernel(BoxSet::Scalar);
+				Uint32 outside = set.OutsideMask(rects[i], first), inside = set.InsideMask(rects[i], first);
+				BoxSet::SetKernel(kernel);
+				if (set.OutsideMask(rects[i], first) != outside || set.InsideMask(rects[i], first) != inside)
+					matched = 0;
+			}
+		}
+	}
+	BoxSet::SetKernel(previous);
+	return matched;
+}
+
+//Find the boxes overlapping a rectangle with each kernel: scalar (0), SSE2 (1) or AVX2 (2).
+static void BM_BoxSetOverlapped(benchmark::State& state)
+{
+	int kernel = (int)state.range(0);
+	int count = (int)state.range(1);
+	if (!BoxSet::HasKernel(kernel))
+	{
+		state.SkipWithError("The kernel isn't supported");
+		return;
+	}
+	if (!MatchesScalar(kernel))
+	{
+		state.SkipWithError("The kernel disagrees with the scalar kernel");
+		return;
+	}
+	BoxSet set(RandomBoxes(count, 1));
+	std::vector<int> hits;
+	int previous = BoxSet::GetKernel();
+	BoxSet::SetKernel(kernel);
+	for (auto _ : state)
+	{
+		hits.clear();
+		benchmark::DoNotOptimize(set.Overlapped({ 60,60,8,8 }, hits));
+	}
+	BoxSet::SetKernel(previous);
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_BoxSetOverlapped)->ArgNames({ "kernel","count" })->ArgsProduct({ { 0,1,2 },{ 64,1024,16384 } });
+
+//Test a rectangle inside all boxes with each kernel, which scans the whole set without an early exit.
+static void BM_BoxSetInsideCollided(benchmark::State& state)
+{
+	int kernel = (int)state.range(0);
+	int count = (int)state.range(1);
+	if (!BoxSet::HasKernel(kernel))
+	{
+		state.SkipWithError("The kernel isn't supported");
+		return;
+	}
+	std::vector<SDL_Rect> boxes(count, { 0,0,100,100 });
+	BoxSet set(boxes);
+	int previous = BoxSet::GetKernel();
+	BoxSet::SetKernel(kernel);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(set.InsideCollided({ 10,10,8,8 }));
+	BoxSet::SetKernel(previous);
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_BoxSetInsideCollided)->ArgNames({ "kernel","count" })->ArgsProduct({ { 0,1,2 },{ 64,1024,16384 } });
\ No newline at end of file
@@ -0,0 +1,45 @@
+/*
+ * Measure the collision tests between groups of boxes at various box counts.
+ * The boxes never overlap, which is the worst case where every pair is tested.
+ */
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <SDL.h>
+#include <collision.h>
+
+/*
+ * \brief Place boxes on a grid, apart from each other.
+ * \param count The number of boxes.
+ * \param x The left edge of the grid.
+ * \return A vector containing the boxes.
+ */
+static std::vector<SDL_Rect> GridBoxes(int count, int x)
+{
+	std::vector<SDL_Rect> boxes;
+	for (int i = 0; i < count; i++)
+		boxes.push_back({ x + i % 32 * 20,i / 32 * 20,10,10 });
+	return boxes;
+}
+
+//Test two groups of the same size against each other.
+static void BM_OutsideCollided(benchmark::State& state)
+{
+	int count = (int)state.range(0);
+	std::vector<SDL_Rect> A = GridBoxes(count, 0), B = GridBoxes(count, 32 * 20);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(OutsideCollided(A, B));
+	state.SetItemsProcessed(state.iterations() * count * count);
+}
+BENCHMARK(BM_OutsideCollided)->RangeMultiplier(4)->Range(4, 1024);
+
+//Test a group against a range containing all boxes.
+static void BM_InsideCollided(benchmark::State& state)
+{
+	int count = (int)state.range(0);
+	std::vector<SDL_Rect> A = GridBoxes(count, 0);
+	SDL_Rect range = { -1,-1,32 * 20 + 2,(count / 32 + 1) * 20 + 2 };
+	for (auto _ : state)
+		benchmark::DoNotOptimize(InsideCollided(A, range));
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_InsideCollided)->RangeMultiplier(4)->Range(4, 1024);
\ No newline at end of file
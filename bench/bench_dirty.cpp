@@ -0,0 +1,69 @@
+/*
+ * Measure Window::Redraw with dirty rects on an offscreen window, when a texture moves and when nothing changes.
+ * A texture drawn at a new point with nothing else marked must present a frame, which is checked on every iteration.
+ */
+#include <memory>
+#include <benchmark/benchmark.h>
+#include <SDL.h>
+#include <window.h>
+#include <texture.h>
+#include "fixture.h"
+
+//Draw a texture at a new point every frame, with nothing else marked dirty.
+static void BM_RedrawMoved(benchmark::State& state)
+{
+	Window window;
+	if (!window.InitOffscreen(640, 480) || !window.EnableDirty(true))
+	{
+		state.SkipWithError("Can't create an offscreen window with dirty rects");
+		return;
+	}
+	std::shared_ptr<Texture> texture = BlankTexture(window.GetRenderer(), 32, 32);
+	int x = 0;
+	auto draw = [&]()
+	{
+		texture->Clear({ x,100 });
+	};
+	window.Redraw(draw);
+	for (auto _ : state)
+	{
+		x = (x + 7) % 600;
+		if (!window.Redraw(draw))
+		{
+			state.SkipWithError("A texture drawn at a new point didn't present a frame");
+			break;
+		}
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RedrawMoved);
+
+//Draw textures at the same points every frame, which only runs the pass finding changes and presents nothing.
+static void BM_RedrawIdle(benchmark::State& state)
+{
+	int count = (int)state.range(0);
+	Window window;
+	if (!window.InitOffscreen(640, 480) || !window.EnableDirty(true))
+	{
+		state.SkipWithError("Can't create an offscreen window with dirty rects");
+		return;
+	}
+	std::shared_ptr<Texture> texture = BlankTexture(window.GetRenderer(), 16, 16);
+	auto draw = [&]()
+	{
+		for (int i = 0; i < count; i++)
+			texture->Clear({ i * 37 % 624,i * 91 % 464 });
+	};
+	window.Redraw(draw);
+	window.Redraw(draw);
+	for (auto _ : state)
+	{
+		if (window.Redraw(draw))
+		{
+			state.SkipWithError("An unchanged frame was presented");
+			break;
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_RedrawIdle)->RangeMultiplier(4)->Range(64, 4096);
\ No newline at end of file
@@ -0,0 +1,73 @@
+/*
+ * Compare moving many objects stored as MovableTexture objects against an EntityStore,
+ * which keeps the same data in packed arrays, and measure rendering the store through a camera.
+ */
+#include <memory>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <SDL.h>
+#include <texture.h>
+#include <entity.h>
+#include "fixture.h"
+
+//Move separately allocated MovableTexture objects one after another.
+static void BM_MovableTextureMove(benchmark::State& state)
+{
+	int count = (int)state.range(0);
+	Screen screen;
+	SDL_Renderer* renderer = screen.renderer;
+	std::shared_ptr<Texture> source = BlankTexture(renderer, 20, 20);
+	AABBTree obstacles(Walls());
+	std::vector<std::unique_ptr<MovableTexture>> textures;
+	for (int i = 0; i < count; i++)
+	{
+		textures.push_back(std::unique_ptr<MovableTexture>(new MovableTexture()));
+		textures[i]->CreateFromTexture(source, Spawn(i), { 0,0,World,World }, { { 2,2,16,16 } });
+		Hold(*textures[i], i);
+	}
+	for (auto _ : state)
+		for (int i = 0; i < count; i++)
+			textures[i]->Move(obstacles);
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_MovableTextureMove)->RangeMultiplier(4)->Range(1024, 16384);
+
+//Move the same objects in an entity store.
+static void BM_EntityStoreMove(benchmark::State& state)
+{
+	int count = (int)state.range(0);
+	AABBTree obstacles(Walls());
+	EntityStore store;
+	store.Init(NULL);
+	store.Reserve(count, count);
+	for (int i = 0; i < count; i++)
+	{
+		Entity entity(store, store.Create(-1, Spawn(i), { 0,0,World,World }, { { 2,2,16,16 } }));
+		//The same velocities as the movable textures.
+		entity.SetVelocity(i % 2 ? 2 : -2, i % 3 ? 2 : -2);
+	}
+	for (auto _ : state)
+		store.Move(obstacles);
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_EntityStoreMove)->RangeMultiplier(4)->Range(1024, 16384);
+
+//Render an entity store through a camera on the software renderer, where most entities are culled.
+static void BM_EntityStoreRender(benchmark::State& state)
+{
+	int count = (int)state.range(0);
+	Screen screen;
+	SDL_Renderer* renderer = screen.renderer;
+	std::shared_ptr<Texture> texture = BlankTexture(renderer, 20, 20);
+	EntityStore store;
+	store.Init(renderer);
+	int id = store.AddTexture(texture);
+	for (int i = 0; i < count; i++)
+		store.Create(id, { i * 37 % World,i * 91 % World }, { 0,0,World,World }, { { 2,2,16,16 } });
+	SDL_Rect camera = { 1024,1024,640,480 };
+	for (auto _ : state)
+		store.Render(camera);
+	state.SetItemsProcessed(state.iterations() * count);
+	state.counters["drawn"] = store.GetDrawn();
+}
+BENCHMARK(BM_EntityStoreRender)->RangeMultiplier(4)->Range(1024, 16384);
\ No newline at end of file
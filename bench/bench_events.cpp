@@ -0,0 +1,91 @@
+/*
+ * Compare polling events and handing each one to every widget against an EventHub,
+ * which drains the queue in bulk, merges mouse motions and calls only the handlers of the target window.
+ * Every iteration pushes a burst of mouse motions and key presses spread over the windows of the widgets.
+ *
+ * Events are pushed by hand on the dummy video driver.
+ */
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <SDL.h>
+#include <eventhub.h>
+
+//A widget counting the events of its window.
+struct Widget
+{
+	Uint32 window;
+	int hits;
+	void HandleEvent(const SDL_Event& event)
+	{
+		if (EventWindowID(event) == window)
+			hits++;
+	}
+};
+
+/*
+ * \brief Push a burst of 48 mouse motions and 16 key presses.
+ * \param windows The number of windows which the events are spread over.
+ */
+static void PushBurst(int windows)
+{
+	for (int i = 0; i < 64; i++)
+	{
+		SDL_Event event = {};
+		if (i % 4 == 3)
+		{
+			event.type = SDL_KEYDOWN;
+			event.key.windowID = i % windows + 1;
+			event.key.keysym.sym = SDLK_a;
+		}
+		else
+		{
+			event.type = SDL_MOUSEMOTION;
+			event.motion.windowID = 1;
+			event.motion.xrel = 1;
+		}
+		SDL_PushEvent(&event);
+	}
+}
+
+//Poll events one at a time, and hand every event to every widget.
+static void BM_EventFanOut(benchmark::State& state)
+{
+	int count = (int)state.range(0);
+	std::vector<Widget> widgets(count);
+	for (int i = 0; i < count; i++)
+		widgets[i] = { (Uint32)i + 1,0 };
+	SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+	for (auto _ : state)
+	{
+		PushBurst(count);
+		SDL_Event event;
+		while (SDL_PollEvent(&event))
+			for (int i = 0; i < count; i++)
+				widgets[i].HandleEvent(event);
+	}
+	state.SetItemsProcessed(state.iterations() * 64);
+}
+BENCHMARK(BM_EventFanOut)->RangeMultiplier(4)->Range(4, 1024);
+
+//Pump events through a hub, where every widget handles its own window.
+static void BM_EventHub(benchmark::State& state)
+{
+	int count = (int)state.range(0);
+	std::vector<Widget> widgets(count);
+	EventHub hub;
+	for (int i = 0; i < count; i++)
+	{
+		widgets[i] = { (Uint32)i + 1,0 };
+		Widget* widget = &widgets[i];
+		hub.SubscribeWindow(widget->window, [widget](const SDL_Event& event) { widget->HandleEvent(event); });
+	}
+	SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+	for (auto _ : state)
+	{
+		PushBurst(count);
+		hub.Pump();
+	}
+	state.SetItemsProcessed(state.iterations() * 64);
+	state.counters["coalesced"] = benchmark::Counter((double)hub.GetCoalesced(), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_EventHub)->RangeMultiplier(4)->Range(4, 1024);
\ No newline at end of file
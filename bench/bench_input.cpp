@@ -0,0 +1,70 @@
+/*
+ * Measure TextInput typing character by character and pasting from the clipboard,
+ * and the overhead of reading timers in both modes.
+ *
+ * The clipboard works on the dummy video driver.
+ */
+#include <string>
+#include <benchmark/benchmark.h>
+#include <SDL.h>
+#include <textinput.h>
+#include <timer.h>
+
+//Type characters into a text one event at a time.
+static void BM_TextInputAppend(benchmark::State& state)
+{
+	int length = (int)state.range(0);
+	SDL_Event event;
+	event.type = SDL_TEXTINPUT;
+	event.text.text[0] = 'a';
+	event.text.text[1] = '\0';
+	for (auto _ : state)
+	{
+		TextInput input;
+		for (int i = 0; i < length; i++)
+			input.HandleEvent(event);
+		benchmark::DoNotOptimize(input.Length());
+	}
+	state.SetItemsProcessed(state.iterations() * length);
+}
+BENCHMARK(BM_TextInputAppend)->Arg(16)->Arg(256)->Arg(4096);
+
+//Paste a block of text with ctrl+v.
+static void BM_TextInputPaste(benchmark::State& state)
+{
+	int length = (int)state.range(0);
+	SDL_SetClipboardText(std::string(length, 'a').c_str());
+	SDL_Event event;
+	event.type = SDL_KEYDOWN;
+	event.key.keysym.sym = SDLK_v;
+	event.key.keysym.mod = KMOD_LCTRL;
+	for (auto _ : state)
+	{
+		TextInput input;
+		for (int i = 0; i < 16; i++)
+			input.HandleEvent(event);
+		benchmark::DoNotOptimize(input.Length());
+	}
+	state.SetBytesProcessed(state.iterations() * 16 * length);
+}
+BENCHMARK(BM_TextInputPaste)->Arg(64)->Arg(4096);
+
+//Read a running timer, in milliseconds (0) or by the performance counter (1).
+static void BM_TimerGetTime(benchmark::State& state)
+{
+	Timer timer(state.range(0) != 0);
+	timer.Start();
+	for (auto _ : state)
+		benchmark::DoNotOptimize(timer.GetTime());
+}
+BENCHMARK(BM_TimerGetTime)->ArgName("precise")->Arg(0)->Arg(1);
+
+//Read a running precise timer in nanoseconds.
+static void BM_TimerGetTimeNS(benchmark::State& state)
+{
+	Timer timer(1);
+	timer.Start();
+	for (auto _ : state)
+		benchmark::DoNotOptimize(timer.GetTimeNS());
+}
+BENCHMARK(BM_TimerGetTimeNS);
\ No newline at end of file
@@ -0,0 +1,58 @@
+/*
+ * Measure how batched moves of many textures scale with the number of threads of a job system.
+ * Every texture tests its boxes against its range and a tree of static obstacles on each move,
+ * and the moves are spread over 1 to N threads, where N is the number of CPU cores.
+ */
+#include <memory>
+#include <thread>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <SDL.h>
+#include <jobs.h>
+#include <texture.h>
+#include "fixture.h"
+
+//Move textures among obstacles with a number of threads.
+static void BM_MoveAll(benchmark::State& state)
+{
+	int threads = (int)state.range(0);
+	int count = (int)state.range(1);
+	Screen screen;
+	SDL_Renderer* renderer = screen.renderer;
+	std::shared_ptr<Texture> source = BlankTexture(renderer, 20, 20);
+	AABBTree obstacles(Walls());
+	std::vector<std::unique_ptr<MovableTexture>> textures;
+	std::vector<MovableTexture*> movers;
+	for (int i = 0; i < count; i++)
+	{
+		textures.push_back(std::unique_ptr<MovableTexture>(new MovableTexture()));
+		textures[i]->CreateFromTexture(source, Spawn(i), { 0,0,World,World }, { { 2,2,16,16 } });
+		Hold(*textures[i], i);
+		movers.push_back(textures[i].get());
+	}
+	JobSystem jobs;
+	jobs.Init(threads - 1);
+	for (auto _ : state)
+		MovableTexture::MoveAll(jobs, movers, obstacles);
+	state.SetItemsProcessed(state.iterations() * count);
+	state.counters["threads"] = jobs.GetThreads();
+	state.counters["steals"] = (double)jobs.GetSteals();
+	jobs.free();
+}
+
+/*
+ * \brief Run with 1, 2, 4 and so on threads up to the number of CPU cores, on a few numbers of textures.
+ */
+static void ThreadCounts(benchmark::internal::Benchmark* benchmark)
+{
+	int cores = (int)std::thread::hardware_concurrency();
+	if (cores < 1)
+		cores = 1;
+	for (int count = 1024; count <= 16384; count *= 4)
+	{
+		for (int threads = 1; threads < cores; threads *= 2)
+			benchmark->Args({ threads,count });
+		benchmark->Args({ cores,count });
+	}
+}
+BENCHMARK(BM_MoveAll)->Apply(ThreadCounts)->UseRealTime();
\ No newline at end of file
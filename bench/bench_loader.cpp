@@ -0,0 +1,88 @@
+/*
+ * Compare loading a level of images synchronously with Texture::CreateFromImage
+ * against the asynchronous ImageLoader with different numbers of worker threads.
+ * Textures are uploaded to the software renderer, so no window or GPU is needed.
+ */
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <SDL.h>
+#include <texture.h>
+#include <imageloader.h>
+#include "fixture.h"
+
+//The number of images in a level.
+static const int Images = 200;
+//The size of every image.
+static const int ImageSize = 256;
+
+/*
+ * \brief Write the images of a level into BMP files.
+ * \return A vector containing the paths of the images.
+ */
+static std::vector<std::string> WriteLevel()
+{
+	std::vector<std::string> files;
+	for (int i = 0; i < Images; i++)
+	{
+		files.push_back("bench_image_" + std::to_string(i) + ".bmp");
+		WriteImage(files.back(), ImageSize, { (Uint8)i,(Uint8)(i * 3),(Uint8)(i * 7),255 });
+	}
+	return files;
+}
+
+//Load every image on the rendering thread.
+static void BM_LoadSynchronous(benchmark::State& state)
+{
+	std::vector<std::string> files = WriteLevel();
+	Screen screen;
+	SDL_Renderer* renderer = screen.renderer;
+	std::vector<Texture> textures(Images);
+	for (auto _ : state)
+	{
+		for (int i = 0; i < Images; i++)
+			textures[i].CreateFromImage(renderer, files[i].c_str());
+		for (int i = 0; i < Images; i++)
+			textures[i].free();
+	}
+	state.counters["images/s"] = benchmark::Counter((double)state.iterations() * Images, benchmark::Counter::kIsRate);
+	RemoveImages(files);
+}
+BENCHMARK(BM_LoadSynchronous)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+//Decode images on worker threads, and upload a bounded number of them in every frame.
+static void BM_LoadAsynchronous(benchmark::State& state)
+{
+	int threads = (int)state.range(0);
+	std::vector<std::string> files = WriteLevel();
+	Screen screen;
+	SDL_Renderer* renderer = screen.renderer;
+	ImageLoader loader;
+	loader.Start(threads);
+	double images = 0, megabytes = 0;
+	int frames = 0;
+	for (auto _ : state)
+	{
+		std::vector<ImageHandle> handles;
+		for (int i = 0; i < Images; i++)
+			handles.push_back(loader.Load(files[i].c_str()));
+		//Keep rendering frames while the level loads.
+		while (loader.Pending() > 0)
+		{
+			loader.Upload(renderer, 8);
+			SDL_RenderClear(renderer);
+			SDL_RenderPresent(renderer);
+			frames++;
+		}
+		images = loader.ImagesPerSecond();
+		megabytes = loader.MegabytesPerSecond();
+		for (int i = 0; i < Images; i++)
+			handles[i].Get().free();
+	}
+	state.counters["decode_images/s"] = images;
+	state.counters["decode_MB/s"] = megabytes;
+	state.counters["frames_while_loading"] = benchmark::Counter(frames, benchmark::Counter::kAvgIterations);
+	loader.free();
+	RemoveImages(files);
+}
+BENCHMARK(BM_LoadAsynchronous)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
\ No newline at end of file
@@ -0,0 +1,85 @@
+/*
+ * Compare the jitter of frame pacing between the legacy millisecond FPSmonitor::Control
+ * and the deadline based pacing modes. Every frame spends a varying amount of time on work,
+ * and the periods between the starts of frames are measured by the performance counter.
+ * The CPU time spent waiting is reported against the wall time waited, since spinning keeps a core busy.
+ */
+#include <math.h>
+#include <time.h>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <SDL.h>
+#include <FPS.h>
+#include <error.h>
+
+//The number of frames in an iteration.
+static const int Frames = 240;
+
+/*
+ * \brief Busy-wait to simulate the work of a frame.
+ * \param us The number of microseconds.
+ */
+static void Work(int us)
+{
+	Uint64 end = SDL_GetPerformanceCounter() + SDL_GetPerformanceFrequency() * us / 1000000;
+	while (SDL_GetPerformanceCounter() < end)
+		;
+}
+
+//Run frames at the target FPS with one of the pacing modes.
+static void BM_Pacing(benchmark::State& state)
+{
+	int pacing = (int)state.range(0);
+	int fps = (int)state.range(1);
+	double frequency = (double)SDL_GetPerformanceFrequency();
+	double target = 1000.0 / fps;
+	std::vector<double> periods;
+	periods.reserve(Frames);
+	double total = 0, deviation = 0, worst = 0;
+	double waited = 0, busy = 0;
+	int missed = 0;
+	for (auto _ : state)
+	{
+		FPSmonitor monitor;
+		monitor.SetPrecise(1);
+		monitor.SetPacing(pacing);
+		monitor.SetFPS(fps);
+		periods.clear();
+		Uint64 first = SDL_GetPerformanceCounter(), previous = first;
+		for (int i = 0; i < Frames; i++)
+		{
+			monitor.StartOneFrame();
+			//Work between a quarter and a half of the frame.
+			Work((int)(target * 1000 * (0.25 + 0.25 * (i % 7) / 6)));
+			Uint64 before = SDL_GetPerformanceCounter();
+			clock_t cpu = clock();
+			monitor.Control();
+			busy += (double)(clock() - cpu) * 1000 / CLOCKS_PER_SEC;
+			waited += (SDL_GetPerformanceCounter() - before) * 1000 / frequency;
+			monitor.EndOneFrame();
+			Uint64 now = SDL_GetPerformanceCounter();
+			periods.push_back((now - previous) * 1000 / frequency);
+			previous = now;
+		}
+		total += (previous - first) * 1000 / frequency;
+		for (int i = 0; i < periods.size(); i++)
+		{
+			double error = fabs(periods[i] - target);
+			deviation += error;
+			if (error > worst)
+				worst = error;
+		}
+		missed += monitor.GetMissedDeadlines();
+	}
+	double frames = (double)state.iterations() * Frames;
+	state.counters["mean_period_ms"] = total / frames;
+	state.counters["target_period_ms"] = target;
+	state.counters["mean_jitter_ms"] = deviation / frames;
+	state.counters["max_jitter_ms"] = worst;
+	state.counters["missed_deadlines"] = missed;
+	state.counters["wait_cpu_pct"] = waited > 0 ? busy * 100 / waited : 0;
+}
+BENCHMARK(BM_Pacing)->ArgNames({ "pacing","fps" })
+	->Args({ FPSmonitor::Legacy,60 })->Args({ FPSmonitor::CatchUp,60 })->Args({ FPSmonitor::Skip,60 })
+	->Args({ FPSmonitor::Legacy,144 })->Args({ FPSmonitor::CatchUp,144 })->Args({ FPSmonitor::Skip,144 })
+	->Iterations(2)->Unit(benchmark::kMillisecond)->UseRealTime();
\ No newline at end of file
@@ -0,0 +1,77 @@
+/*
+ * Compare drawing sprites of interleaved textures immediately against queueing them in a RenderQueue,
+ * which groups their textures and blend modes as far as the order of overlapping sprites allows.
+ */
+#include <memory>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <SDL.h>
+#include <texture.h>
+#include <renderqueue.h>
+#include "fixture.h"
+
+//The number of textures which the sprites take turns using.
+static const int Textures = 4;
+
+/*
+ * \brief Create the textures of sprites.
+ * \param renderer The renderer.
+ * \param blendmode The blend mode of the textures.
+ * \return A vector containing the textures, 16 pixels wide and high.
+ */
+static std::vector<std::shared_ptr<Texture>> Sprites(SDL_Renderer* renderer, SDL_BlendMode blendmode)
+{
+	std::vector<std::shared_ptr<Texture>> textures;
+	for (int i = 0; i < Textures; i++)
+	{
+		textures.push_back(BlankTexture(renderer, 16, 16));
+		textures[i]->SetBlend(blendmode);
+	}
+	return textures;
+}
+
+//Draw opaque sprites in call order, switching textures on every sprite.
+static void BM_RenderImmediate(benchmark::State& state)
+{
+	int count = (int)state.range(0);
+	Screen screen;
+	SDL_Renderer* renderer = screen.renderer;
+	std::vector<std::shared_ptr<Texture>> textures = Sprites(renderer, SDL_BLENDMODE_NONE);
+	for (auto _ : state)
+	{
+		SDL_RenderClear(renderer);
+		for (int i = 0; i < count; i++)
+			textures[i % Textures]->Clear({ i * 37 % 624,i * 91 % 464 });
+		SDL_RenderPresent(renderer);
+	}
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_RenderImmediate)->RangeMultiplier(4)->Range(256, 16384);
+
+//Queue the same sprites, opaque in call order (0) or blended on a layer of their own per texture (1), and draw them sorted.
+static void BM_RenderQueued(benchmark::State& state)
+{
+	int count = (int)state.range(0);
+	bool blended = state.range(1) != 0;
+	Screen screen;
+	SDL_Renderer* renderer = screen.renderer;
+	std::vector<std::shared_ptr<Texture>> textures = Sprites(renderer, blended ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
+	RenderQueue queue;
+	for (auto _ : state)
+	{
+		SDL_RenderClear(renderer);
+		queue.Begin(renderer);
+		for (int i = 0; i < count; i++)
+		{
+			if (blended)
+				queue.SetLayer(i % Textures);
+			textures[i % Textures]->Clear({ i * 37 % 624,i * 91 % 464 });
+		}
+		queue.End();
+		SDL_RenderPresent(renderer);
+	}
+	state.SetItemsProcessed(state.iterations() * count);
+	state.counters["calls"] = queue.GetDrawCalls();
+	state.counters["saved"] = queue.GetSavedChanges();
+}
+BENCHMARK(BM_RenderQueued)->ArgNames({ "count","blended" })->ArgsProduct({ { 256,1024,4096,16384 },{ 0,1 } });
\ No newline at end of file
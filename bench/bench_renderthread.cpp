@@ -0,0 +1,48 @@
+/*
+ * Measure the handoffs between the render thread and the simulation: passing events through the ring,
+ * and recording and publishing frame snapshots through the triple buffer.
+ */
+#include <memory>
+#include <benchmark/benchmark.h>
+#include <SDL.h>
+#include <texture.h>
+#include <renderthread.h>
+#include "fixture.h"
+
+//Pass a burst of events to the simulation, and take them back out.
+static void BM_RenderThreadEvents(benchmark::State& state)
+{
+	int count = (int)state.range(0);
+	RenderThread thread;
+	SDL_Event event = {};
+	event.type = SDL_MOUSEMOTION;
+	for (auto _ : state)
+	{
+		for (int i = 0; i < count; i++)
+			thread.PushEvent(event);
+		SDL_Event taken;
+		while (thread.PollEvent(taken))
+			benchmark::DoNotOptimize(taken);
+	}
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_RenderThreadEvents)->Arg(16)->Arg(256);
+
+//Record a frame of sprites and publish it, as the simulation does every tick.
+static void BM_RenderThreadPublish(benchmark::State& state)
+{
+	int count = (int)state.range(0);
+	Screen screen;
+	SDL_Renderer* renderer = screen.renderer;
+	std::shared_ptr<Texture> texture = BlankTexture(renderer, 16, 16);
+	RenderThread thread;
+	for (auto _ : state)
+	{
+		FrameSnapshot& frame = thread.GetFrame();
+		for (int i = 0; i < count; i++)
+			frame.Clear(*texture, { i * 37 % 624,i * 91 % 464 });
+		thread.Publish();
+	}
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_RenderThreadPublish)->RangeMultiplier(4)->Range(256, 16384);
\ No newline at end of file
@@ -0,0 +1,90 @@
+/*
+ * Measure creating textures from images and text, cutting them into clips,
+ * and rotating them with RenderEx on the software renderer.
+ *
+ * The text benchmark needs a TrueType font given by the SDL_BENCH_FONT environment variable, and is skipped without one.
+ */
+#include <stdlib.h>
+#include <benchmark/benchmark.h>
+#include <SDL.h>
+#include <texture.h>
+#include "fixture.h"
+
+//Load an image into a texture of the software renderer.
+static void BM_CreateFromImage(benchmark::State& state)
+{
+	int size = (int)state.range(0);
+	WriteImage("bench_texture.bmp", size, { 40,120,200,255 });
+	Screen screen;
+	SDL_Renderer* renderer = screen.renderer;
+	Texture texture;
+	for (auto _ : state)
+	{
+		texture.CreateFromImage(renderer, "bench_texture.bmp");
+		texture.free();
+	}
+	state.SetBytesProcessed(state.iterations() * size * size * 4);
+	RemoveImages({ "bench_texture.bmp" });
+}
+BENCHMARK(BM_CreateFromImage)->Arg(64)->Arg(256)->Arg(1024);
+
+//Render a line of text into a texture through the shared font pool.
+static void BM_CreateFromText(benchmark::State& state)
+{
+	const char* font = getenv("SDL_BENCH_FONT");
+	if (font == NULL || GetFontPool().Get(font, 24) == NULL)
+	{
+		state.SkipWithError("Set SDL_BENCH_FONT to the path of a TrueType font");
+		return;
+	}
+	std::string message(state.range(0), 'A');
+	Screen screen;
+	SDL_Renderer* renderer = screen.renderer;
+	Texture texture;
+	for (auto _ : state)
+	{
+		texture.CreateFromText(renderer, message, font, { 0,0,0,255 }, 24);
+		texture.free();
+	}
+	state.SetItemsProcessed(state.iterations() * message.size());
+}
+BENCHMARK(BM_CreateFromText)->Arg(8)->Arg(64);
+
+//Cut a texture into m*n clips.
+static void BM_Cut(benchmark::State& state)
+{
+	int m = (int)state.range(0);
+	WriteImage("bench_cut.bmp", 512, { 40,120,200,255 });
+	Screen screen;
+	SDL_Renderer* renderer = screen.renderer;
+	Texture texture;
+	texture.CreateFromImage(renderer, "bench_cut.bmp");
+	for (auto _ : state)
+		benchmark::DoNotOptimize(texture.Cut(m, m));
+	state.SetItemsProcessed(state.iterations() * m * m);
+	texture.free();
+	RemoveImages({ "bench_cut.bmp" });
+}
+BENCHMARK(BM_Cut)->Arg(4)->Arg(16)->Arg(64);
+
+//Draw rotated sprites into a frame of the software renderer.
+static void BM_RenderEx(benchmark::State& state)
+{
+	int sprites = (int)state.range(0);
+	WriteImage("bench_render.bmp", 64, { 40,120,200,255 });
+	Screen screen;
+	SDL_Renderer* renderer = screen.renderer;
+	Texture texture;
+	texture.CreateFromImage(renderer, "bench_render.bmp");
+	for (auto _ : state)
+	{
+		SDL_RenderClear(renderer);
+		for (int i = 0; i < sprites; i++)
+			texture.RenderEx({ i * 37 % 576,i * 53 % 416 }, i * 7 % 360, { 32,32 }, SDL_FLIP_NONE);
+		SDL_RenderPresent(renderer);
+	}
+	state.SetItemsProcessed(state.iterations() * sprites);
+	texture.free();
+	RemoveImages({ "bench_render.bmp" });
+}
+BENCHMARK(BM_RenderEx)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond);
\ No newline at end of file
@@ -0,0 +1,108 @@
+/*
+ * Measure scrolling a 4096x4096 tilemap on the software renderer, against drawing the visible tiles
+ * one by one with Texture::Clear, and the collision tests against the solid tiles.
+ */
+#include <memory>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <SDL.h>
+#include <texture.h>
+#include <tilemap.h>
+#include "fixture.h"
+
+//The number of tiles on a side of the map, and the size of a tile.
+static const int Side = 4096;
+static const int Tile = 16;
+
+/*
+ * \brief Get the tile of the generated map at a position.
+ */
+static int TileAt(int x, int y)
+{
+	return (x * 7 + y * 13) % 16;
+}
+
+/*
+ * \brief Create a 4 by 4 tileset of 16 pixels a tile.
+ * \param renderer The renderer of the tileset.
+ * \return The tileset.
+ */
+static std::shared_ptr<Texture> Tileset(SDL_Renderer* renderer)
+{
+	SDL_Surface* image = SDL_CreateRGBSurfaceWithFormat(0, Tile * 4, Tile * 4, 32, SDL_PIXELFORMAT_ARGB8888);
+	for (int i = 0; i < 16; i++)
+	{
+		SDL_Rect rect = { i % 4 * Tile,i / 4 * Tile,Tile,Tile };
+		SDL_FillRect(image, &rect, SDL_MapRGBA(image->format, i * 16, 255 - i * 16, 128, 255));
+	}
+	std::shared_ptr<Texture> tileset = std::make_shared<Texture>();
+	tileset->CreateFromSurface(renderer, image);
+	SDL_FreeSurface(image);
+	return tileset;
+}
+
+//Scroll diagonally over the whole map, drawing the chunks in front of the camera.
+static void BM_TilemapScroll(benchmark::State& state)
+{
+	Screen screen;
+	SDL_Renderer* renderer = screen.renderer;
+	Tilemap map;
+	map.Init(renderer, Tileset(renderer), 4, 4, Side, Side);
+	for (int y = 0; y < Side; y++)
+		for (int x = 0; x < Side; x++)
+			map.SetTile(x, y, TileAt(x, y));
+	SDL_Rect camera = { 0,0,640,480 };
+	int baked = 0;
+	for (auto _ : state)
+	{
+		camera.x = (camera.x + 4) % (Side * Tile - camera.w);
+		camera.y = (camera.y + 4) % (Side * Tile - camera.h);
+		map.Render(camera);
+		baked += map.GetBaked();
+	}
+	state.counters["drawn"] = map.GetDrawn();
+	state.counters["baked"] = benchmark::Counter(baked, benchmark::Counter::kAvgIterations);
+	map.free();
+}
+BENCHMARK(BM_TilemapScroll)->Unit(benchmark::kMicrosecond);
+
+//Scroll the same way, copying every visible tile with Texture::Clear.
+static void BM_TilesClear(benchmark::State& state)
+{
+	Screen screen;
+	SDL_Renderer* renderer = screen.renderer;
+	std::shared_ptr<Texture> tileset = Tileset(renderer);
+	std::vector<SDL_Rect> clips = tileset->Cut(4, 4);
+	SDL_Rect camera = { 0,0,640,480 };
+	for (auto _ : state)
+	{
+		camera.x = (camera.x + 4) % (Side * Tile - camera.w);
+		camera.y = (camera.y + 4) % (Side * Tile - camera.h);
+		for (int y = camera.y / Tile; y <= (camera.y + camera.h - 1) / Tile; y++)
+			for (int x = camera.x / Tile; x <= (camera.x + camera.w - 1) / Tile; x++)
+				tileset->Clear({ x * Tile - camera.x,y * Tile - camera.y }, &clips[TileAt(x, y)]);
+	}
+}
+BENCHMARK(BM_TilesClear)->Unit(benchmark::kMicrosecond);
+
+//Test boxes of 2 by 2 tiles against a map where every 7th tile is solid.
+static void BM_TilemapCollided(benchmark::State& state)
+{
+	Screen screen(64, 64);
+	SDL_Renderer* renderer = screen.renderer;
+	Tilemap map;
+	map.Init(renderer, Tileset(renderer), 4, 4, Side, Side);
+	for (int y = 0; y < Side; y++)
+		for (int x = 0; x < Side; x++)
+			map.SetSolid(x, y, (x + y * 3) % 7 == 0);
+	int i = 0;
+	for (auto _ : state)
+	{
+		SDL_Rect box = { i * 37 % (Side * Tile),i * 91 % (Side * Tile),Tile * 2,Tile * 2 };
+		benchmark::DoNotOptimize(map.OutsideCollided(box));
+		i++;
+	}
+	state.SetItemsProcessed(state.iterations());
+	map.free();
+}
+BENCHMARK(BM_TilemapCollided);
\ No newline at end of file
@@ -0,0 +1,140 @@
+#ifndef fixture_h_
+#define fixture_h_
+
+#include <stdio.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include <SDL.h>
+#include <texture.h>
+#include <error.h>
+
+//The side of the square world in which objects move.
+const int World = 4096;
+
+//A screen without a display, drawn by a software renderer into a surface.
+//Objects using the renderer must be declared after the screen, so that they go away before it.
+struct Screen
+{
+	SDL_Surface* surface;
+	SDL_Renderer* renderer;
+	Screen(int w = 640, int h = 480);
+	~Screen();
+};
+
+/*
+ * \brief Create a screen and its software renderer.
+ * \param w The width of the screen.
+ * \param h The height of the screen.
+ */
+inline Screen::Screen(int w, int h)
+{
+	surface = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ARGB8888);
+	renderer = NULL;
+	if (surface == NULL)
+		SDL_ReportError("SDL_CreateRGBSurfaceWithFormat");
+	else
+	{
+		renderer = SDL_CreateSoftwareRenderer(surface);
+		if (renderer == NULL)
+			SDL_ReportError("SDL_CreateSoftwareRenderer");
+	}
+}
+
+/*
+ * \brief Destroy the renderer and the surface of the screen.
+ */
+inline Screen::~Screen()
+{
+	if (renderer != NULL)
+		SDL_DestroyRenderer(renderer);
+	if (surface != NULL)
+		SDL_FreeSurface(surface);
+}
+
+/*
+ * \brief Create a blank texture, such as for a sprite whose pixels don't matter.
+ * \param renderer The renderer of the texture.
+ * \param w The width of the texture.
+ * \param h The height of the texture.
+ * \return The texture.
+ */
+inline std::shared_ptr<Texture> BlankTexture(SDL_Renderer* renderer, int w, int h)
+{
+	std::shared_ptr<Texture> texture = std::make_shared<Texture>();
+	SDL_Surface* image = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ARGB8888);
+	texture->CreateFromSurface(renderer, image);
+	SDL_FreeSurface(image);
+	return texture;
+}
+
+/*
+ * \brief Write a square BMP image filled with a color into the working directory.
+ * \param file The path of the image.
+ * \param size The width and height of the image.
+ * \param color The color of every pixel.
+ */
+inline void WriteImage(const std::string& file, int size, SDL_Color color)
+{
+	SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, size, size, 32, SDL_PIXELFORMAT_ARGB8888);
+	if (surface == NULL)
+	{
+		SDL_ReportError("SDL_CreateRGBSurfaceWithFormat");
+		return;
+	}
+	SDL_FillRect(surface, NULL, SDL_MapRGBA(surface->format, color.r, color.g, color.b, color.a));
+	if (SDL_SaveBMP(surface, file.c_str()) != 0)
+		SDL_ReportError("SDL_SaveBMP");
+	SDL_FreeSurface(surface);
+}
+
+/*
+ * \brief Remove images written by WriteImage().
+ * \param files The paths of the images.
+ */
+inline void RemoveImages(const std::vector<std::string>& files)
+{
+	for (int i = 0; i < files.size(); i++)
+		remove(files[i].c_str());
+}
+
+/*
+ * \brief Place obstacles on a grid over the world.
+ * \return A vector containing the obstacles.
+ */
+inline std::vector<SDL_Rect> Walls()
+{
+	std::vector<SDL_Rect> walls;
+	for (int i = 0; i < 1024; i++)
+		walls.push_back({ i % 32 * 128 + 60,i / 32 * 128 + 60,16,16 });
+	return walls;
+}
+
+/*
+ * \brief Get the initial position of an object, between the obstacles.
+ * \param i The number of the object.
+ */
+inline SDL_Point Spawn(int i)
+{
+	return { i * 37 % 32 * 128,i * 91 % 32 * 128 };
+}
+
+/*
+ * \brief Give a texture a velocity of 2 pixels on both axes, as if keys were held.
+ * \param texture The texture, 20 pixels wide and high.
+ * \param i The number of the object, which chooses the direction.
+ */
+inline void Hold(MovableTexture& texture, int i)
+{
+	SDL_Keycode keys[2] = { i % 2 ? SDLK_d : SDLK_a,i % 3 ? SDLK_s : SDLK_w };
+	for (int k = 0; k < 2; k++)
+	{
+		SDL_Event event = {};
+		event.type = SDL_KEYDOWN;
+		event.key.keysym.sym = keys[k];
+		texture.HandleEvent(event);
+	}
+}
+
+
+#endif // !fixture_h_
\ No newline at end of file
@@ -0,0 +1,42 @@
+/*
+ * Entry of sdl_bench, which runs every benchmark in this directory without a display.
+ * SDL is initialized with the dummy video driver unless SDL_VIDEODRIVER says otherwise,
+ * and frames are drawn by software renderers into surfaces.
+ *
+ * Results are written as JSON with --benchmark_out=<file> --benchmark_out_format=json,
+ * which the bench_json target of CMakeLists.txt passes.
+ */
+#include <benchmark/benchmark.h>
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_ttf.h>
+#include <font.h>
+#include <error.h>
+
+int main(int argc, char** argv)
+{
+	SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+	if (SDL_Init(SDL_INIT_VIDEO) != 0)
+	{
+		SDL_ReportError("SDL_Init");
+		return 1;
+	}
+	if (TTF_Init() != 0)
+	{
+		TTF_ReportError("TTF_Init");
+		SDL_Quit();
+		return 1;
+	}
+	IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG);
+	benchmark::Initialize(&argc, argv);
+	if (benchmark::ReportUnrecognizedArguments(argc, argv))
+		return 1;
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	//Fonts opened by the benchmarks must be closed before SDL_ttf quits.
+	GetFontPool().free();
+	IMG_Quit();
+	TTF_Quit();
+	SDL_Quit();
+	return 0;
+}
\ No newline at end of file
@@ -1,8 +1,12 @@
 #ifndef fps_h_
 #define fps_h_
 
+#include <chrono>
+#include <thread>
 #include <SDL.h>
 #include <timer.h>
+#include <framestats.h>
+#include <profiler.h>
 
 //FPS monitor wrapper class
 class FPSmonitor
@@ -13,46 +17,101 @@ private:
 	bool control;
 	int TargetFPS;
 	int RealFPS;
+	//The fractional values, measured by the performance counter in precise mode.
+	double FrameTime;
+	double PreciseFPS;
+	FrameStats stats;
+	//Absolute deadlines of paced frames, counted by the performance counter from the anchor.
+	int pacing;
+	Uint64 anchor;
+	Uint64 paced;
+	int missed;
+	//How much longer than asked sleeps have lasted, in performance counter ticks, which is left for yielding.
+	Uint64 oversleep;
+	void Pace();
 public:
+	//Ways of controlling FPS. Legacy sleeps for the rest of the frame in milliseconds, and the others sleep until absolute deadlines.
+	//When a frame runs over, CatchUp keeps the deadlines and runs the following frames without sleeping, while Skip drops the missed deadlines.
+	enum { Legacy, CatchUp, Skip };
 	FPSmonitor();
 	~FPSmonitor();
 	void SetFPS(const int FPS);
+	void SetPrecise(bool precise);
+	void SetPacing(int pacing);
 	void StartOneFrame();
 	void EndOneFrame();
 	void Control();
 	void ChangeControllingState();
 	int GetFPS();
+	double GetPreciseFPS();
+	double GetFrameTime();
+	FrameStats& GetStats();
+	int GetMissedDeadlines();
 };
 
 /*
  * \brief Create an empty monitor.
  */
-FPSmonitor::FPSmonitor()
+inline FPSmonitor::FPSmonitor()
 {
 	control = 1;
 	TargetFPS = 0;
 	RealFPS = 0;
+	FrameTime = 0;
+	PreciseFPS = 0;
+	stats.Init();
+	pacing = Legacy;
+	anchor = 0;
+	paced = 0;
+	missed = 0;
+	oversleep = SDL_GetPerformanceFrequency() / 5000;
 }
 
 /*
  * \brief Deallocate the monitor.
  */
-FPSmonitor::~FPSmonitor()
+inline FPSmonitor::~FPSmonitor()
 {
 	oneframe.~Timer();
 	update.~Timer();
 	control = 1;
 	TargetFPS = 0;
 	RealFPS = 0;
+	FrameTime = 0;
+	PreciseFPS = 0;
 }
 
 /*
  * \brief Set the target FPS for the monitor.
  * \param FPS The FPS at which the program should be running.
  */
-void FPSmonitor::SetFPS(const int FPS)
+inline void FPSmonitor::SetFPS(const int FPS)
 {
 	TargetFPS = FPS;
+	if (FPS > 0)
+		stats.SetBudget(1000.0 / FPS);
+	anchor = 0;
+}
+
+/*
+ * \brief Choose whether frames are measured by the performance counter, which is needed above 1000 FPS or for fractional frame times.
+ * \param precise Whether the monitor measures frames in nanoseconds instead of milliseconds.
+ */
+inline void FPSmonitor::SetPrecise(bool precise)
+{
+	oneframe.SetPrecise(precise);
+	update.SetPrecise(precise);
+}
+
+/*
+ * \brief Choose how FPS is controlled.
+ * \param pacing Legacy, CatchUp or Skip.
+ */
+inline void FPSmonitor::SetPacing(int pacing)
+{
+	this->pacing = pacing;
+	anchor = 0;
+	missed = 0;
 }
 
 /*
@@ -62,21 +121,26 @@ inline void FPSmonitor::StartOneFrame()
 {
 	oneframe.Start();
 	update.Start();
+	GetProfiler().BeginFrame();
 }
 
 /*
  * \brief Inform the monitor that a frame has ended.
  */
-void FPSmonitor::EndOneFrame()
+inline void FPSmonitor::EndOneFrame()
 {
-	//Update the value of real FPS every 100ms.
-	if (update.GetTime() >= 100)
+	FrameTime = oneframe.GetTimeMS();
+	stats.Record(FrameTime);
+	//Update the value of real FPS every 100ms, skipping frames too short to be measured.
+	if (update.GetTime() >= 100 && FrameTime > 0)
 	{
-		RealFPS = 1000 / oneframe.GetTime();
+		PreciseFPS = 1000 / FrameTime;
+		RealFPS = (int)(PreciseFPS + 0.5);
 		update.Reset();
 	}
 	//End the recording of one frame.
 	oneframe.Reset();
+	GetProfiler().EndFrame();
 }
 
 /*
@@ -84,17 +148,65 @@ void FPSmonitor::EndOneFrame()
  */
 inline void FPSmonitor::Control()
 {
+	if (control && TargetFPS > 0 && pacing != Legacy)
+		Pace();
 	//Compensate for the remaining milliseconds under the circumstance of controlling FPS.
-	if (control && oneframe.GetTime() * TargetFPS < 1000)
+	else if (control && TargetFPS > 0 && oneframe.GetTime() * TargetFPS < 1000)
 		SDL_Delay(1000 / TargetFPS - oneframe.GetTime());
 }
 
+/*
+ * \brief Wait until the deadline of the current frame.
+ */
+inline void FPSmonitor::Pace()
+{
+	Uint64 frequency = SDL_GetPerformanceFrequency();
+	Uint64 now = SDL_GetPerformanceCounter();
+	//Start a new schedule, or give up catching up after a hitch longer than a second.
+	if (anchor == 0 || (anchor + paced * frequency / TargetFPS + frequency < now))
+	{
+		//The schedule starts when the current frame started.
+		Uint64 elapsed = oneframe.GetTimeNS() * frequency / 1000000000;
+		anchor = now > elapsed ? now - elapsed : now;
+		paced = 0;
+	}
+	//Deadlines are computed from the anchor rather than added up, so that rounding never drifts.
+	paced++;
+	Uint64 deadline = anchor + paced * frequency / TargetFPS;
+	if (deadline <= now)
+	{
+		missed++;
+		if (pacing == CatchUp)
+			return;
+		//Skip to the first deadline which is still ahead, keeping the phase of the schedule.
+		paced = (now - anchor) * TargetFPS / frequency + 1;
+		deadline = anchor + paced * frequency / TargetFPS;
+	}
+	//Sleep in microseconds while more than the expected oversleep remains, learning the oversleep from every sleep.
+	while (now < deadline && deadline - now > oversleep)
+	{
+		Uint64 asked = deadline - now - oversleep;
+		std::this_thread::sleep_for(std::chrono::microseconds(asked * 1000000 / frequency));
+		Uint64 slept = SDL_GetPerformanceCounter() - now;
+		Uint64 over = slept > asked ? slept - asked : 0;
+		//Follow longer oversleeps at once and shorter ones slowly, but never yield for more than 2ms.
+		if (over > frequency / 500)
+			over = frequency / 500;
+		oversleep = over > oversleep ? over : (oversleep * 7 + over) / 8;
+		now = SDL_GetPerformanceCounter();
+	}
+	//Yield for the last fraction, which is too short to sleep.
+	while (SDL_GetPerformanceCounter() < deadline)
+		std::this_thread::yield();
+}
+
 /*
  * \brief Change whether FPS will be controlled.
  */
 inline void FPSmonitor::ChangeControllingState()
 {
 	control = !control;
+	anchor = 0;
 }
 
 /*
@@ -106,5 +218,41 @@ inline int FPSmonitor::GetFPS()
 	return RealFPS;
 }
 
+/*
+ * \brief Get current FPS with the fraction.
+ * \return Current FPS.
+ */
+inline double FPSmonitor::GetPreciseFPS()
+{
+	return PreciseFPS;
+}
+
+/*
+ * \brief Get the duration of the last frame.
+ * \return The number of milliseconds, with the fraction in precise mode.
+ */
+inline double FPSmonitor::GetFrameTime()
+{
+	return FrameTime;
+}
+
+/*
+ * \brief Get the statistics of the latest frames.
+ * \return The frame statistics, whose budget follows the target FPS.
+ */
+inline FrameStats& FPSmonitor::GetStats()
+{
+	return stats;
+}
+
+/*
+ * \brief Get the number of paced frames which ran over their deadlines.
+ * \return The number of frames.
+ */
+inline int FPSmonitor::GetMissedDeadlines()
+{
+	return missed;
+}
+
 
 #endif // !fps_h_
\ No newline at end of file
@@ -2,11 +2,32 @@
 #define SDL_addition_h_
 
 #include <window.h>
+#include <dirty.h>
 #include <collision.h>
+#include <spatialhash.h>
+#include <boxset.h>
+#include <aabbtree.h>
+#include <font.h>
 #include <texture.h>
+#include <texturecache.h>
+#include <imageloader.h>
+#include <atlas.h>
+#include <spritebatch.h>
+#include <renderqueue.h>
 #include <timer.h>
+#include <framestats.h>
 #include <FPS.h>
+#include <loop.h>
+#include <jobs.h>
+#include <entity.h>
+#include <tilemap.h>
+#include <profiler.h>
+#include <gapbuffer.h>
 #include <textinput.h>
+#include <textbox.h>
+#include <eventhub.h>
+#include <windowmanager.h>
+#include <renderthread.h>
 #include <error.h>
 
 
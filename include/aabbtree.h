@@ -0,0 +1,582 @@
+#ifndef aabbtree_h_
+#define aabbtree_h_
+
+#include <vector>
+#include <algorithm>
+#include <SDL.h>
+#include <collision.h>
+
+//Static bounding volume hierarchy wrapper class
+class AABBTree
+{
+private:
+	struct Node
+	{
+		//The bounding box of all boxes below the node.
+		int left, top, right, bottom;
+		//The index of the first child, or -1 for a leaf. See Second() for the second child.
+		int child;
+		//The index of the node following the whole subtree, only valid after compacting.
+		int skip;
+		//The range of boxes held by a leaf.
+		int first, count;
+	};
+	std::vector<Node> nodes;
+	std::vector<SDL_Rect> rects;
+	//The original index of each box in the order of leaves.
+	std::vector<int> order;
+	//The boxes copied in the order of leaves, only filled after compacting.
+	std::vector<SDL_Rect> packed;
+	bool compacted;
+	void Split(int node, int first, int count);
+	void Flatten(int node, std::vector<Node>& flat);
+	int Second(const Node& node);
+	SDL_Rect Box(int item);
+	bool Intersected(const Node& node, SDL_Rect rect);
+	bool Contained(const Node& node, SDL_Point point);
+	bool Crossed(int left, int top, int right, int bottom, double x, double y, double dx, double dy, double limit, double& t);
+	int Sweep(SDL_Rect rect, int dx, int dy);
+public:
+	//The largest number of boxes held by a leaf.
+	static const int LeafSize = 4;
+	AABBTree();
+	AABBTree(const std::vector<SDL_Rect>& rects);
+	~AABBTree();
+	void Build(const std::vector<SDL_Rect>& rects);
+	void Compact();
+	int Overlapped(SDL_Rect rect, std::vector<int>& hits);
+	bool OutsideCollided(SDL_Rect rect);
+	bool OutsideCollided(const std::vector<SDL_Rect>& A);
+	int Contain(SDL_Point point, std::vector<int>& hits);
+	bool RayCast(SDL_Point from, SDL_Point to, double& t, int& index);
+	int OutsideSweptX(const std::vector<SDL_Rect>& A, int dx);
+	int OutsideSweptY(const std::vector<SDL_Rect>& A, int dy);
+	bool IsCompacted();
+	int Size();
+	void free();
+};
+
+/*
+ * \brief Create an empty tree.
+ */
+inline AABBTree::AABBTree()
+{
+	compacted = false;
+}
+
+/*
+ * \brief Create a tree from a set of static boxes.
+ * \param rects The static collision boxes.
+ */
+inline AABBTree::AABBTree(const std::vector<SDL_Rect>& rects)
+{
+	compacted = false;
+	Build(rects);
+}
+
+/*
+ * \brief Deallocate the tree.
+ */
+inline AABBTree::~AABBTree()
+{
+	free();
+}
+
+/*
+ * \brief Build the tree from a set of static boxes. The boxes are copied, so the source may be released.
+ * \param rects The static collision boxes.
+ */
+inline void AABBTree::Build(const std::vector<SDL_Rect>& rects)
+{
+	free();
+	if (rects.empty())
+		return;
+	this->rects = rects;
+	order.resize(rects.size());
+	for (int i = 0; i < order.size(); i++)
+		order[i] = i;
+	nodes.reserve(rects.size() * 2 / LeafSize + 1);
+	nodes.push_back(Node());
+	Split(0, 0, (int)rects.size());
+}
+
+/*
+ * \brief Compute the bounding box of a node, and split it at the median of its longer side.
+ */
+inline void AABBTree::Split(int node, int first, int count)
+{
+	//Bound all boxes of the node.
+	SDL_Rect box = rects[order[first]];
+	int left = box.x, top = box.y, right = box.x + box.w, bottom = box.y + box.h;
+	for (int i = first + 1; i < first + count; i++)
+	{
+		box = rects[order[i]];
+		left = std::min(left, box.x);
+		top = std::min(top, box.y);
+		right = std::max(right, box.x + box.w);
+		bottom = std::max(bottom, box.y + box.h);
+	}
+	nodes[node] = { left,top,right,bottom,-1,-1,first,count };
+	if (count <= LeafSize)
+		return;
+	//Sort the boxes by their centers on the longer side, and cut them into halves.
+	int middle = first + count / 2;
+	const std::vector<SDL_Rect>& all = rects;
+	if (right - left >= bottom - top)
+		std::nth_element(order.begin() + first, order.begin() + middle, order.begin() + first + count,
+			[&all](int a, int b) { return all[a].x * 2 + all[a].w < all[b].x * 2 + all[b].w; });
+	else
+		std::nth_element(order.begin() + first, order.begin() + middle, order.begin() + first + count,
+			[&all](int a, int b) { return all[a].y * 2 + all[a].h < all[b].y * 2 + all[b].h; });
+	int child = (int)nodes.size();
+	nodes.resize(nodes.size() + 2);
+	nodes[node].child = child;
+	nodes[node].count = 0;
+	Split(child, first, middle - first);
+	Split(child + 1, middle, first + count - middle);
+}
+
+/*
+ * \brief Rearrange the tree into a flat array in depth-first order.
+ * After compacting, a query walks the array forward and jumps over subtrees, without a stack,
+ * and the boxes of every leaf lie next to each other.
+ */
+inline void AABBTree::Compact()
+{
+	if (compacted || nodes.empty())
+		return;
+	std::vector<Node> flat;
+	flat.reserve(nodes.size());
+	packed.reserve(rects.size());
+	std::vector<int> leaforder;
+	leaforder.reserve(order.size());
+	//Copy the boxes of leaves in the order they are visited.
+	Flatten(0, flat);
+	for (int i = 0; i < flat.size(); i++)
+	{
+		if (flat[i].child < 0)
+		{
+			int first = (int)packed.size();
+			for (int j = 0; j < flat[i].count; j++)
+			{
+				packed.push_back(rects[order[flat[i].first + j]]);
+				leaforder.push_back(order[flat[i].first + j]);
+			}
+			flat[i].first = first;
+		}
+	}
+	nodes.swap(flat);
+	order.swap(leaforder);
+	std::vector<SDL_Rect>().swap(rects);
+	compacted = true;
+}
+
+/*
+ * \brief Copy a subtree into the flat array in depth-first order.
+ */
+inline void AABBTree::Flatten(int node, std::vector<Node>& flat)
+{
+	int index = (int)flat.size();
+	flat.push_back(nodes[node]);
+	if (nodes[node].child >= 0)
+	{
+		int child = nodes[node].child;
+		flat[index].child = index + 1;
+		Flatten(child, flat);
+		Flatten(child + 1, flat);
+	}
+	flat[index].skip = (int)flat.size();
+}
+
+/*
+ * \brief Get the index of the second child of a node.
+ */
+inline int AABBTree::Second(const Node& node)
+{
+	//After compacting, the second child follows the whole subtree of the first one.
+	return compacted ? nodes[node.child].skip : node.child + 1;
+}
+
+/*
+ * \brief Get a box in the order of leaves.
+ */
+inline SDL_Rect AABBTree::Box(int item)
+{
+	return compacted ? packed[item] : rects[order[item]];
+}
+
+/*
+ * \brief Determine if a node may hold boxes colliding externally with a rectangle.
+ */
+inline bool AABBTree::Intersected(const Node& node, SDL_Rect rect)
+{
+	return node.left < rect.x + rect.w && rect.x < node.right && node.top < rect.y + rect.h && rect.y < node.bottom;
+}
+
+/*
+ * \brief Determine if a node may hold boxes containing a point.
+ */
+inline bool AABBTree::Contained(const Node& node, SDL_Point point)
+{
+	return node.left <= point.x && point.x < node.right && node.top <= point.y && point.y < node.bottom;
+}
+
+/*
+ * \brief Clip a segment against a box with the slab method.
+ * \param t Set to the fraction of the segment at which it enters the box.
+ * \return 1 if the segment enters the box before the fraction (limit), or 0 if not.
+ */
+inline bool AABBTree::Crossed(int left, int top, int right, int bottom, double x, double y, double dx, double dy, double limit, double& t)
+{
+	double enter = 0, leave = limit;
+	//Clip on X axis.
+	if (dx == 0)
+	{
+		if (x < left || x > right)
+			return 0;
+	}
+	else
+	{
+		double t1 = (left - x) / dx, t2 = (right - x) / dx;
+		if (t1 > t2)
+			std::swap(t1, t2);
+		enter = std::max(enter, t1);
+		leave = std::min(leave, t2);
+	}
+	//Clip on Y axis.
+	if (dy == 0)
+	{
+		if (y < top || y > bottom)
+			return 0;
+	}
+	else
+	{
+		double t1 = (top - y) / dy, t2 = (bottom - y) / dy;
+		if (t1 > t2)
+			std::swap(t1, t2);
+		enter = std::max(enter, t1);
+		leave = std::min(leave, t2);
+	}
+	if (enter > leave)
+		return 0;
+	t = enter;
+	return 1;
+}
+
+/*
+ * \brief Find all boxes colliding externally with a rectangle.
+ * \param rect The target rectangle.
+ * \param hits A vector to which the indices of colliding boxes (in the source vector) are appended.
+ * \return The number of colliding boxes.
+ */
+inline int AABBTree::Overlapped(SDL_Rect rect, std::vector<int>& hits)
+{
+	int found = 0;
+	if (nodes.empty())
+		return 0;
+	if (compacted)
+	{
+		int i = 0;
+		while (i < nodes.size())
+		{
+			const Node& node = nodes[i];
+			if (!Intersected(node, rect))
+				i = node.skip;
+			else
+			{
+				if (node.child < 0)
+				{
+					for (int j = node.first; j < node.first + node.count; j++)
+					{
+						if (::OutsideCollided(packed[j], rect))
+						{
+							hits.push_back(order[j]);
+							found++;
+						}
+					}
+				}
+				i++;
+			}
+		}
+		return found;
+	}
+	int stack[64], top = 0;
+	stack[top++] = 0;
+	while (top > 0)
+	{
+		const Node& node = nodes[stack[--top]];
+		if (!Intersected(node, rect))
+			continue;
+		if (node.child >= 0)
+		{
+			stack[top++] = Second(node);
+			stack[top++] = node.child;
+		}
+		else
+		{
+			for (int j = node.first; j < node.first + node.count; j++)
+			{
+				if (::OutsideCollided(rects[order[j]], rect))
+				{
+					hits.push_back(order[j]);
+					found++;
+				}
+			}
+		}
+	}
+	return found;
+}
+
+/*
+ * \brief Determine if any box collides externally with a rectangle.
+ * \param rect The target rectangle.
+ * \return 1 if collided, or 0 if not collided.
+ */
+inline bool AABBTree::OutsideCollided(SDL_Rect rect)
+{
+	if (nodes.empty())
+		return 0;
+	if (compacted)
+	{
+		int i = 0;
+		while (i < nodes.size())
+		{
+			const Node& node = nodes[i];
+			if (!Intersected(node, rect))
+				i = node.skip;
+			else
+			{
+				if (node.child < 0)
+					for (int j = node.first; j < node.first + node.count; j++)
+						if (::OutsideCollided(packed[j], rect))
+							return 1;
+				i++;
+			}
+		}
+		return 0;
+	}
+	int stack[64], top = 0;
+	stack[top++] = 0;
+	while (top > 0)
+	{
+		const Node& node = nodes[stack[--top]];
+		if (!Intersected(node, rect))
+			continue;
+		if (node.child >= 0)
+		{
+			stack[top++] = Second(node);
+			stack[top++] = node.child;
+		}
+		else
+		{
+			for (int j = node.first; j < node.first + node.count; j++)
+				if (::OutsideCollided(rects[order[j]], rect))
+					return 1;
+		}
+	}
+	return 0;
+}
+
+/*
+ * \brief Determine if any box collides externally with a set of collision boxes.
+ * \param A The target collision boxes.
+ * \return 1 if collided, or 0 if not collided.
+ */
+inline bool AABBTree::OutsideCollided(const std::vector<SDL_Rect>& A)
+{
+	for (int i = 0; i < A.size(); i++)
+	{
+		if (OutsideCollided(A[i]))
+			return 1;
+	}
+	return 0;
+}
+
+/*
+ * \brief Find all boxes containing a point.
+ * \param point The target point.
+ * \param hits A vector to which the indices of boxes (in the source vector) are appended.
+ * \return The number of boxes containing the point.
+ */
+inline int AABBTree::Contain(SDL_Point point, std::vector<int>& hits)
+{
+	int found = 0;
+	if (nodes.empty())
+		return 0;
+	int stack[64], top = 0;
+	stack[top++] = 0;
+	while (top > 0)
+	{
+		const Node& node = nodes[stack[--top]];
+		if (!Contained(node, point))
+			continue;
+		if (node.child >= 0)
+		{
+			stack[top++] = Second(node);
+			stack[top++] = node.child;
+		}
+		else
+		{
+			for (int j = node.first; j < node.first + node.count; j++)
+			{
+				SDL_Rect box = Box(j);
+				if (box.x <= point.x && point.x < box.x + box.w && box.y <= point.y && point.y < box.y + box.h)
+				{
+					hits.push_back(order[j]);
+					found++;
+				}
+			}
+		}
+	}
+	return found;
+}
+
+/*
+ * \brief Cast a segment through the tree and find the first box it hits.
+ * \param from The start of the segment.
+ * \param to The end of the segment.
+ * \param t Set to the fraction (0 ~ 1) of the segment at which the first box is hit.
+ * \param index Set to the index of the first box (in the source vector).
+ * \return 1 if a box was hit, or 0 if the segment is clear.
+ */
+inline bool AABBTree::RayCast(SDL_Point from, SDL_Point to, double& t, int& index)
+{
+	double x = from.x, y = from.y, dx = (double)to.x - from.x, dy = (double)to.y - from.y;
+	double best = 1, enter = 0;
+	int hit = -1;
+	if (nodes.empty())
+		return 0;
+	int stack[64], top = 0;
+	stack[top++] = 0;
+	while (top > 0)
+	{
+		const Node& node = nodes[stack[--top]];
+		//Skip the nodes which are missed, or entered later than the nearest box found so far.
+		if (!Crossed(node.left, node.top, node.right, node.bottom, x, y, dx, dy, best, enter))
+			continue;
+		if (node.child >= 0)
+		{
+			stack[top++] = Second(node);
+			stack[top++] = node.child;
+		}
+		else
+		{
+			for (int j = node.first; j < node.first + node.count; j++)
+			{
+				SDL_Rect box = Box(j);
+				if (box.w <= 0 || box.h <= 0)
+					continue;
+				if (Crossed(box.x, box.y, box.x + box.w, box.y + box.h, x, y, dx, dy, best, enter) && (hit < 0 || enter < best))
+				{
+					best = enter;
+					hit = order[j];
+				}
+			}
+		}
+	}
+	if (hit < 0)
+		return 0;
+	t = best;
+	index = hit;
+	return 1;
+}
+
+/*
+ * \brief Compute how far a rectangle can move along one axis before it collides externally with any box.
+ */
+inline int AABBTree::Sweep(SDL_Rect rect, int dx, int dy)
+{
+	int distance = dx != 0 ? dx : dy;
+	if (nodes.empty() || distance == 0)
+		return distance;
+	//Only the boxes touching the area swept by the rectangle may block it.
+	SDL_Rect area = rect;
+	if (dx != 0)
+	{
+		area.w += dx > 0 ? dx : -dx;
+		area.x += dx > 0 ? 0 : dx;
+	}
+	else
+	{
+		area.h += dy > 0 ? dy : -dy;
+		area.y += dy > 0 ? 0 : dy;
+	}
+	int stack[64], top = 0;
+	stack[top++] = 0;
+	while (top > 0 && distance != 0)
+	{
+		const Node& node = nodes[stack[--top]];
+		if (!Intersected(node, area))
+			continue;
+		if (node.child >= 0)
+		{
+			stack[top++] = Second(node);
+			stack[top++] = node.child;
+		}
+		else
+		{
+			for (int j = node.first; j < node.first + node.count; j++)
+				distance = dx != 0 ? ::OutsideSweptX(rect, distance, Box(j)) : ::OutsideSweptY(rect, distance, Box(j));
+		}
+	}
+	return distance;
+}
+
+/*
+ * \brief Compute how far a set of collision boxes can move in X direction before it collides externally with any box.
+ * \param A The moving collision boxes.
+ * \param dx The distance to move, negative for moving left.
+ * \return The distance the boxes can move, which has the same sign as (dx) and is not longer than it.
+ */
+inline int AABBTree::OutsideSweptX(const std::vector<SDL_Rect>& A, int dx)
+{
+	for (int i = 0; i < A.size() && dx != 0; i++)
+		dx = Sweep(A[i], dx, 0);
+	return dx;
+}
+
+/*
+ * \brief Compute how far a set of collision boxes can move in Y direction before it collides externally with any box.
+ * \param A The moving collision boxes.
+ * \param dy The distance to move, negative for moving up.
+ * \return The distance the boxes can move, which has the same sign as (dy) and is not longer than it.
+ */
+inline int AABBTree::OutsideSweptY(const std::vector<SDL_Rect>& A, int dy)
+{
+	for (int i = 0; i < A.size() && dy != 0; i++)
+		dy = Sweep(A[i], 0, dy);
+	return dy;
+}
+
+/*
+ * \brief Determine if the tree has been compacted.
+ * \return 1 if compacted, or 0 if not.
+ */
+inline bool AABBTree::IsCompacted()
+{
+	return compacted;
+}
+
+/*
+ * \brief Get the number of boxes in the tree.
+ * \return The number of boxes.
+ */
+inline int AABBTree::Size()
+{
+	return (int)order.size();
+}
+
+/*
+ * \brief Deallocate the tree.
+ */
+inline void AABBTree::free()
+{
+	std::vector<Node>().swap(nodes);
+	std::vector<SDL_Rect>().swap(rects);
+	std::vector<int>().swap(order);
+	std::vector<SDL_Rect>().swap(packed);
+	compacted = false;
+}
+
+
+#endif // !aabbtree_h_
\ No newline at end of file
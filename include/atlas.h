@@ -0,0 +1,457 @@
+#ifndef atlas_h_
+#define atlas_h_
+
+#include <vector>
+#include <SDL.h>
+#include <SDL_image.h>
+#include <error.h>
+
+//Skyline rectangle packer class
+class Skyline
+{
+private:
+	struct Segment
+	{
+		int x, y, w;
+	};
+	int w, h;
+	int used;
+	//The top edge of packed rectangles, from left to right.
+	std::vector<Segment> segments;
+	int Fit(int index, int width);
+public:
+	Skyline();
+	Skyline(int w, int h);
+	~Skyline();
+	void Init(int w, int h);
+	bool Insert(int width, int height, SDL_Rect& place);
+	double Occupancy();
+	void free();
+};
+
+/*
+ * \brief Create an empty packer.
+ */
+inline Skyline::Skyline()
+{
+	w = 0;
+	h = 0;
+	used = 0;
+}
+
+/*
+ * \brief Create a packer for an area.
+ * \param w The width of the area.
+ * \param h The height of the area.
+ */
+inline Skyline::Skyline(int w, int h)
+{
+	Init(w, h);
+}
+
+/*
+ * \brief Deallocate the packer.
+ */
+inline Skyline::~Skyline()
+{
+	free();
+}
+
+/*
+ * \brief Clear the packer and start packing an area.
+ * \param w The width of the area.
+ * \param h The height of the area.
+ */
+inline void Skyline::Init(int w, int h)
+{
+	this->w = w;
+	this->h = h;
+	used = 0;
+	segments.assign(1, { 0,0,w });
+}
+
+/*
+ * \brief Find the lowest height at which a rectangle fits on top of the skyline starting from a segment.
+ * \return The height, or -1 if the rectangle doesn't fit.
+ */
+inline int Skyline::Fit(int index, int width)
+{
+	int x = segments[index].x;
+	if (x + width > w)
+		return -1;
+	int y = 0;
+	for (int i = index; width > 0; i++)
+	{
+		if (segments[i].y > y)
+			y = segments[i].y;
+		width -= segments[i].w;
+	}
+	return y;
+}
+
+/*
+ * \brief Pack a rectangle into the area, as low (and then as left) as possible.
+ * \param width The width of the rectangle.
+ * \param height The height of the rectangle.
+ * \param place Set to the position and size of the packed rectangle.
+ * \return 1 if packed, or 0 if there's no room left.
+ */
+inline bool Skyline::Insert(int width, int height, SDL_Rect& place)
+{
+	int best = -1, best_y = h;
+	for (int i = 0; i < segments.size(); i++)
+	{
+		int y = Fit(i, width);
+		if (y >= 0 && y + height <= h && y < best_y)
+		{
+			best = i;
+			best_y = y;
+		}
+	}
+	if (best < 0)
+		return 0;
+	place = { segments[best].x,best_y,width,height };
+	//Raise the skyline over the new rectangle, and cut the segments hidden under it.
+	Segment top = { place.x,best_y + height,width };
+	int right = place.x + width;
+	int i = best;
+	while (i < segments.size() && segments[i].x < right)
+	{
+		int end = segments[i].x + segments[i].w;
+		if (end <= right)
+			segments.erase(segments.begin() + i);
+		else
+		{
+			segments[i].w = end - right;
+			segments[i].x = right;
+			break;
+		}
+	}
+	segments.insert(segments.begin() + best, top);
+	//Merge neighbouring segments of the same height.
+	for (int j = 0; j + 1 < segments.size(); j++)
+	{
+		if (segments[j].y == segments[j + 1].y)
+		{
+			segments[j].w += segments[j + 1].w;
+			segments.erase(segments.begin() + j + 1);
+			j--;
+		}
+	}
+	used += width * height;
+	return 1;
+}
+
+/*
+ * \brief Get the fraction of the area covered by packed rectangles.
+ * \return The occupancy, from 0 to 1.
+ */
+inline double Skyline::Occupancy()
+{
+	if (w == 0 || h == 0)
+		return 0;
+	return (double)used / ((double)w * h);
+}
+
+/*
+ * \brief Deallocate the packer.
+ */
+inline void Skyline::free()
+{
+	std::vector<Segment>().swap(segments);
+	w = 0;
+	h = 0;
+	used = 0;
+}
+
+//A packed image in an atlas.
+struct AtlasRegion
+{
+	int page;
+	SDL_Rect rect;
+};
+
+//Texture atlas wrapper class
+class Atlas
+{
+private:
+	SDL_Renderer* rend;
+	int size;
+	int padding;
+	std::vector<Skyline> packers;
+	std::vector<SDL_Surface*> surfaces;
+	std::vector<SDL_Texture*> pages;
+	std::vector<AtlasRegion> regions;
+	bool built;
+	bool NewPage();
+	bool Upload(int page, const SDL_Rect* rect);
+public:
+	Atlas();
+	~Atlas();
+	void Init(SDL_Renderer* renderer, int size = 2048, int padding = 1);
+	int Add(SDL_Surface* surface, const SDL_Rect* clip = NULL);
+	int AddImage(const char* file);
+	std::vector<int> AddImage(const char* file, int m, int n);
+	bool Build();
+	AtlasRegion GetRegion(int id);
+	SDL_Texture* GetPage(int page);
+	int GetPageSize();
+	int PageCount();
+	int Size();
+	void free();
+};
+
+/*
+ * \brief Create an empty atlas.
+ */
+inline Atlas::Atlas()
+{
+	rend = NULL;
+	size = 0;
+	padding = 0;
+	built = false;
+}
+
+/*
+ * \brief Deallocate the atlas.
+ */
+inline Atlas::~Atlas()
+{
+	free();
+}
+
+/*
+ * \brief Start an empty atlas.
+ * \param renderer The renderer which should copy parts of the atlas.
+ * \param size The width and height of every page.
+ * \param padding The number of empty pixels left around every image, which stops filtering from bleeding.
+ */
+inline void Atlas::Init(SDL_Renderer* renderer, int size, int padding)
+{
+	free();
+	rend = renderer;
+	this->size = size;
+	this->padding = padding;
+}
+
+/*
+ * \brief Open a new page.
+ * \return 1 if succeeded, or 0 if failed.
+ */
+inline bool Atlas::NewPage()
+{
+	SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, size, size, 32, SDL_PIXELFORMAT_ARGB8888);
+	if (surface == NULL)
+	{
+		SDL_ReportError("SDL_CreateRGBSurfaceWithFormat");
+		return 0;
+	}
+	//Start from transparent pixels.
+	SDL_FillRect(surface, NULL, SDL_MapRGBA(surface->format, 0, 0, 0, 0));
+	surfaces.push_back(surface);
+	packers.push_back(Skyline(size, size));
+	pages.push_back(NULL);
+	return 1;
+}
+
+/*
+ * \brief Copy an image, or a portion of it, into the atlas.
+ * \param surface The source image, which is still owned by the caller.
+ * \param clip A pointer to the portion of source image, or NULL for the entire image.
+ * \return The number of the packed image, or -1 if failed.
+ */
+inline int Atlas::Add(SDL_Surface* surface, const SDL_Rect* clip)
+{
+	SDL_Rect source = { 0,0,surface->w,surface->h };
+	if (clip != NULL)
+		source = *clip;
+	if (source.w + padding * 2 > size || source.h + padding * 2 > size)
+		return -1;
+	//Try the pages from the latest one, and open a new page if all are full.
+	SDL_Rect place;
+	int page = (int)packers.size() - 1;
+	while (page >= 0 && !packers[page].Insert(source.w + padding * 2, source.h + padding * 2, place))
+		page--;
+	if (page < 0)
+	{
+		if (!NewPage())
+			return -1;
+		page = (int)packers.size() - 1;
+		packers[page].Insert(source.w + padding * 2, source.h + padding * 2, place);
+	}
+	//Copy the pixels as they are, including alpha.
+	SDL_Rect target = { place.x + padding,place.y + padding,source.w,source.h };
+	SDL_BlendMode mode;
+	SDL_GetSurfaceBlendMode(surface, &mode);
+	SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+	if (SDL_BlitSurface(surface, &source, surfaces[page], &target) != 0)
+		SDL_ReportError("SDL_BlitSurface");
+	SDL_SetSurfaceBlendMode(surface, mode);
+	regions.push_back({ page,{ place.x + padding,place.y + padding,source.w,source.h } });
+	//Once built, upload only the new image instead of the whole page.
+	if (built)
+		Upload(page, &target);
+	return (int)regions.size() - 1;
+}
+
+/*
+ * \brief Load an image into the atlas.
+ * \param file The path of the source image.
+ * \return The number of the packed image, or -1 if failed.
+ */
+inline int Atlas::AddImage(const char* file)
+{
+	SDL_Surface* surface = IMG_Load(file);
+	if (surface == NULL)
+	{
+		SDL_ReportError("IMG_Load");
+		return -1;
+	}
+	int id = Add(surface);
+	SDL_FreeSurface(surface);
+	return id;
+}
+
+/*
+ * \brief Load an image, cut it into (m) rows and (n) columns like Texture::Cut, and pack every clip into the atlas.
+ * \param file The path of the source image.
+ * \param m The target row number. (Y axis)
+ * \param n The target column number. (X axis)
+ * \return A vector containing the numbers of packed clips, in the same order as Texture::Cut.
+ */
+inline std::vector<int> Atlas::AddImage(const char* file, int m, int n)
+{
+	std::vector<int> ids;
+	SDL_Surface* surface = IMG_Load(file);
+	if (surface == NULL)
+	{
+		SDL_ReportError("IMG_Load");
+		return ids;
+	}
+	int single_w = surface->w / n, single_h = surface->h / m;
+	for (int row = 0; row < m; row++)
+	{
+		for (int column = 0; column < n; column++)
+		{
+			SDL_Rect clip = { column * single_w,row * single_h,single_w,single_h };
+			ids.push_back(Add(surface, &clip));
+		}
+	}
+	SDL_FreeSurface(surface);
+	return ids;
+}
+
+/*
+ * \brief Copy the pixels of a page, or a portion of it, into its texture.
+ * \param page The number of the page.
+ * \param rect A pointer to the portion of the page, or NULL for the entire page.
+ * \return 1 if succeeded, or 0 if failed.
+ */
+inline bool Atlas::Upload(int page, const SDL_Rect* rect)
+{
+	if (pages[page] == NULL)
+	{
+		pages[page] = SDL_CreateTexture(rend, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, size, size);
+		if (pages[page] == NULL)
+		{
+			SDL_ReportError("SDL_CreateTexture");
+			return 0;
+		}
+		SDL_SetTextureBlendMode(pages[page], SDL_BLENDMODE_BLEND);
+		rect = NULL;
+	}
+	SDL_Surface* surface = surfaces[page];
+	const Uint8* pixels = (const Uint8*)surface->pixels;
+	if (rect != NULL)
+		pixels += rect->y * surface->pitch + rect->x * 4;
+	if (SDL_UpdateTexture(pages[page], rect, pixels, surface->pitch) != 0)
+	{
+		SDL_ReportError("SDL_UpdateTexture");
+		return 0;
+	}
+	return 1;
+}
+
+/*
+ * \brief Upload the pages into textures. Images added afterwards are uploaded as soon as they are packed.
+ * \return 1 if succeeded, or 0 if failed.
+ */
+inline bool Atlas::Build()
+{
+	built = true;
+	for (int i = 0; i < pages.size(); i++)
+		if (!Upload(i, NULL))
+			return 0;
+	return 1;
+}
+
+/*
+ * \brief Get the page and position of a packed image.
+ * \param id The number of the packed image.
+ * \return The region of the image.
+ */
+inline AtlasRegion Atlas::GetRegion(int id)
+{
+	return regions[id];
+}
+
+/*
+ * \brief Get the texture of a page.
+ * \param page The number of the page.
+ * \return The texture, or NULL if the page hasn't been built.
+ */
+inline SDL_Texture* Atlas::GetPage(int page)
+{
+	return pages[page];
+}
+
+/*
+ * \brief Get the size of pages.
+ * \return The width and height of every page.
+ */
+inline int Atlas::GetPageSize()
+{
+	return size;
+}
+
+/*
+ * \brief Get the number of pages.
+ * \return The number of pages.
+ */
+inline int Atlas::PageCount()
+{
+	return (int)pages.size();
+}
+
+/*
+ * \brief Get the number of packed images.
+ * \return The number of packed images.
+ */
+inline int Atlas::Size()
+{
+	return (int)regions.size();
+}
+
+/*
+ * \brief Deallocate the atlas and all its pages.
+ */
+inline void Atlas::free()
+{
+	for (int i = 0; i < pages.size(); i++)
+	{
+		if (pages[i] != NULL)
+			SDL_DestroyTexture(pages[i]);
+		SDL_FreeSurface(surfaces[i]);
+	}
+	std::vector<SDL_Texture*>().swap(pages);
+	std::vector<SDL_Surface*>().swap(surfaces);
+	std::vector<Skyline>().swap(packers);
+	std::vector<AtlasRegion>().swap(regions);
+	rend = NULL;
+	size = 0;
+	padding = 0;
+	built = false;
+}
+
+
+#endif // !atlas_h_
\ No newline at end of file
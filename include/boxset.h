@@ -0,0 +1,460 @@
+#ifndef boxset_h_
+#define boxset_h_
+
+#include <vector>
+#include <limits.h>
+#include <SDL.h>
+#include <collision.h>
+
+//Compile the SIMD kernels, unless BOXSET_NO_SIMD is defined. SSE2 is part of every x86-64 CPU, while AVX2 is
+//compiled for its own functions only and picked at runtime, so that the build doesn't need -mavx2.
+#if !defined(BOXSET_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define BOXSET_SSE2
+#include <emmintrin.h>
+#endif
+#if !defined(BOXSET_NO_SIMD) && (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define BOXSET_AVX2
+#define BOXSET_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif !defined(BOXSET_NO_SIMD) && defined(_M_X64)
+#define BOXSET_AVX2
+#define BOXSET_TARGET_AVX2
+#include <immintrin.h>
+#endif
+
+//Collision box set wrapper class (structure of arrays)
+class BoxSet
+{
+private:
+	//The edges of boxes, padded with empty boxes to a multiple of 16.
+	std::vector<Sint32> left, top, right, bottom;
+	int number;
+	void Pad();
+	static int& CurrentKernel();
+	Uint32 OutsideMaskScalar(SDL_Rect rect, int first);
+	Uint32 InsideMaskScalar(SDL_Rect rect, int first);
+#if defined(BOXSET_SSE2)
+	Uint32 OutsideMaskSSE2(SDL_Rect rect, int first);
+	Uint32 InsideMaskSSE2(SDL_Rect rect, int first);
+#endif
+#if defined(BOXSET_AVX2)
+	BOXSET_TARGET_AVX2 Uint32 OutsideMaskAVX2(SDL_Rect rect, int first);
+	BOXSET_TARGET_AVX2 Uint32 InsideMaskAVX2(SDL_Rect rect, int first);
+#endif
+public:
+	//The number of boxes tested by a single mask.
+	static const int Block = 16;
+	//The kernels testing a block of boxes.
+	enum Kernel { Scalar, SSE2, AVX2 };
+	static bool HasKernel(int kernel);
+	static int GetKernel();
+	static bool SetKernel(int kernel);
+	BoxSet();
+	BoxSet(const std::vector<SDL_Rect>& rects);
+	~BoxSet();
+	void Assign(const std::vector<SDL_Rect>& rects);
+	int Add(SDL_Rect rect);
+	void Set(int index, SDL_Rect rect);
+	SDL_Rect Get(int index);
+	Uint32 OutsideMask(SDL_Rect rect, int first);
+	Uint32 InsideMask(SDL_Rect rect, int first);
+	int Overlapped(SDL_Rect rect, std::vector<int>& hits);
+	bool OutsideCollided(SDL_Rect rect);
+	bool InsideCollided(SDL_Rect rect);
+	int Size();
+	void free();
+};
+
+/*
+ * \brief Create an empty box set.
+ */
+inline BoxSet::BoxSet()
+{
+	number = 0;
+}
+
+/*
+ * \brief Create a box set from a vector of rectangles.
+ * \param rects The source collision boxes.
+ */
+inline BoxSet::BoxSet(const std::vector<SDL_Rect>& rects)
+{
+	number = 0;
+	Assign(rects);
+}
+
+/*
+ * \brief Deallocate the box set.
+ */
+inline BoxSet::~BoxSet()
+{
+	free();
+}
+
+/*
+ * \brief Fill the arrays up to a multiple of 16 with empty boxes, which never collide.
+ */
+inline void BoxSet::Pad()
+{
+	int padded = (number + Block - 1) / Block * Block;
+	left.resize(padded, INT_MAX);
+	top.resize(padded, INT_MAX);
+	right.resize(padded, INT_MIN);
+	bottom.resize(padded, INT_MIN);
+}
+
+/*
+ * \brief Replace all boxes in the set.
+ * \param rects The source collision boxes.
+ */
+inline void BoxSet::Assign(const std::vector<SDL_Rect>& rects)
+{
+	number = (int)rects.size();
+	left.resize(number);
+	top.resize(number);
+	right.resize(number);
+	bottom.resize(number);
+	for (int i = 0; i < number; i++)
+	{
+		left[i] = rects[i].x;
+		top[i] = rects[i].y;
+		right[i] = rects[i].x + rects[i].w;
+		bottom[i] = rects[i].y + rects[i].h;
+	}
+	Pad();
+}
+
+/*
+ * \brief Add a box to the set.
+ * \param rect The box to be added.
+ * \return The index of the box.
+ */
+inline int BoxSet::Add(SDL_Rect rect)
+{
+	//Overwrite the first padding box, or grow by a whole block.
+	if (number == left.size())
+	{
+		number += Block;
+		Pad();
+		number -= Block;
+	}
+	Set(number, rect);
+	return number++;
+}
+
+/*
+ * \brief Move or resize a box in the set.
+ * \param index The index of the box.
+ * \param rect The new position and size of the box.
+ */
+inline void BoxSet::Set(int index, SDL_Rect rect)
+{
+	left[index] = rect.x;
+	top[index] = rect.y;
+	right[index] = rect.x + rect.w;
+	bottom[index] = rect.y + rect.h;
+}
+
+/*
+ * \brief Get a box in the set.
+ * \param index The index of the box.
+ * \return The box as a rectangle.
+ */
+inline SDL_Rect BoxSet::Get(int index)
+{
+	return { left[index],top[index],right[index] - left[index],bottom[index] - top[index] };
+}
+
+/*
+ * \brief Determine if a kernel is compiled and supported by the CPU.
+ * \param kernel The kernel, such as BoxSet::AVX2.
+ * \return 1 if supported, or 0 if not.
+ */
+inline bool BoxSet::HasKernel(int kernel)
+{
+	switch (kernel)
+	{
+		case Scalar:
+			return 1;
+#if defined(BOXSET_SSE2)
+		case SSE2:
+			return 1;
+#endif
+#if defined(BOXSET_AVX2)
+		case AVX2:
+			return SDL_HasAVX2() == SDL_TRUE;
+#endif
+	}
+	return 0;
+}
+
+/*
+ * \brief Get the kernel used by all box sets, which is the widest one supported unless set otherwise.
+ */
+inline int& BoxSet::CurrentKernel()
+{
+	static int kernel = HasKernel(AVX2) ? AVX2 : HasKernel(SSE2) ? SSE2 : Scalar;
+	return kernel;
+}
+
+/*
+ * \brief Get the kernel used by all box sets.
+ * \return The kernel, such as BoxSet::AVX2.
+ */
+inline int BoxSet::GetKernel()
+{
+	return CurrentKernel();
+}
+
+/*
+ * \brief Set the kernel used by all box sets, such as for comparing the kernels.
+ * \param kernel The kernel, such as BoxSet::Scalar.
+ * \return 1 if succeeded, or 0 if the kernel isn't supported.
+ */
+inline bool BoxSet::SetKernel(int kernel)
+{
+	if (!HasKernel(kernel))
+		return 0;
+	CurrentKernel() = kernel;
+	return 1;
+}
+
+/*
+ * \brief Test a rectangle against 16 boxes at once for external collision.
+ * \param rect The target rectangle.
+ * \param first The index of the first box to test, which must be a multiple of 16.
+ * \return A mask whose bit (i) is set if box (first + i) collides with the rectangle.
+ */
+inline Uint32 BoxSet::OutsideMask(SDL_Rect rect, int first)
+{
+	switch (CurrentKernel())
+	{
+#if defined(BOXSET_AVX2)
+		case AVX2:
+			return OutsideMaskAVX2(rect, first);
+#endif
+#if defined(BOXSET_SSE2)
+		case SSE2:
+			return OutsideMaskSSE2(rect, first);
+#endif
+	}
+	return OutsideMaskScalar(rect, first);
+}
+
+/*
+ * \brief Test a rectangle against 16 boxes at once for internal collision.
+ * \param rect The target rectangle.
+ * \param first The index of the first box to test, which must be a multiple of 16.
+ * \return A mask whose bit (i) is set if neither box (first + i) nor the rectangle contains the other.
+ */
+inline Uint32 BoxSet::InsideMask(SDL_Rect rect, int first)
+{
+	switch (CurrentKernel())
+	{
+#if defined(BOXSET_AVX2)
+		case AVX2:
+			return InsideMaskAVX2(rect, first);
+#endif
+#if defined(BOXSET_SSE2)
+		case SSE2:
+			return InsideMaskSSE2(rect, first);
+#endif
+	}
+	return InsideMaskScalar(rect, first);
+}
+
+/*
+ * \brief Test 16 boxes for external collision one by one, which is the reference of the other kernels.
+ */
+inline Uint32 BoxSet::OutsideMaskScalar(SDL_Rect rect, int first)
+{
+	Uint32 mask = 0;
+	for (int i = 0; i < Block && first + i < number; i++)
+		if (::OutsideCollided(Get(first + i), rect))
+			mask |= 1u << i;
+	return mask;
+}
+
+/*
+ * \brief Test 16 boxes for internal collision one by one, which is the reference of the other kernels.
+ */
+inline Uint32 BoxSet::InsideMaskScalar(SDL_Rect rect, int first)
+{
+	Uint32 mask = 0;
+	for (int i = 0; i < Block && first + i < number; i++)
+		if (::InsideCollided(Get(first + i), rect))
+			mask |= 1u << i;
+	return mask;
+}
+
+#if defined(BOXSET_SSE2)
+/*
+ * \brief Test 16 boxes for external collision, 4 at a time.
+ */
+inline Uint32 BoxSet::OutsideMaskSSE2(SDL_Rect rect, int first)
+{
+	Uint32 mask = 0;
+	__m128i x1 = _mm_set1_epi32(rect.x), x2 = _mm_set1_epi32(rect.x + rect.w);
+	__m128i y1 = _mm_set1_epi32(rect.y), y2 = _mm_set1_epi32(rect.y + rect.h);
+	for (int i = 0; i < Block; i += 4)
+	{
+		__m128i l = _mm_loadu_si128((const __m128i*)&left[first + i]);
+		__m128i t = _mm_loadu_si128((const __m128i*)&top[first + i]);
+		__m128i r = _mm_loadu_si128((const __m128i*)&right[first + i]);
+		__m128i b = _mm_loadu_si128((const __m128i*)&bottom[first + i]);
+		//Collided if the box starts before the rectangle ends and ends after the rectangle starts, on both axes.
+		__m128i m = _mm_and_si128(_mm_and_si128(_mm_cmpgt_epi32(x2, l), _mm_cmpgt_epi32(r, x1)),
+			_mm_and_si128(_mm_cmpgt_epi32(y2, t), _mm_cmpgt_epi32(b, y1)));
+		mask |= (Uint32)_mm_movemask_ps(_mm_castsi128_ps(m)) << i;
+	}
+	return mask;
+}
+
+/*
+ * \brief Test 16 boxes for internal collision, 4 at a time.
+ */
+inline Uint32 BoxSet::InsideMaskSSE2(SDL_Rect rect, int first)
+{
+	Uint32 mask = 0;
+	__m128i x1 = _mm_set1_epi32(rect.x), x2 = _mm_set1_epi32(rect.x + rect.w);
+	__m128i y1 = _mm_set1_epi32(rect.y), y2 = _mm_set1_epi32(rect.y + rect.h);
+	for (int i = 0; i < Block; i += 4)
+	{
+		__m128i l = _mm_loadu_si128((const __m128i*)&left[first + i]);
+		__m128i t = _mm_loadu_si128((const __m128i*)&top[first + i]);
+		__m128i r = _mm_loadu_si128((const __m128i*)&right[first + i]);
+		__m128i b = _mm_loadu_si128((const __m128i*)&bottom[first + i]);
+		//The box sticks out of the rectangle.
+		__m128i out = _mm_or_si128(_mm_or_si128(_mm_cmpgt_epi32(x1, l), _mm_cmpgt_epi32(r, x2)),
+			_mm_or_si128(_mm_cmpgt_epi32(y1, t), _mm_cmpgt_epi32(b, y2)));
+		//The rectangle sticks out of the box.
+		__m128i in = _mm_or_si128(_mm_or_si128(_mm_cmpgt_epi32(l, x1), _mm_cmpgt_epi32(x2, r)),
+			_mm_or_si128(_mm_cmpgt_epi32(t, y1), _mm_cmpgt_epi32(y2, b)));
+		mask |= (Uint32)_mm_movemask_ps(_mm_castsi128_ps(_mm_and_si128(out, in))) << i;
+	}
+	return mask;
+}
+#endif
+
+#if defined(BOXSET_AVX2)
+/*
+ * \brief Test 16 boxes for external collision, 8 at a time.
+ */
+BOXSET_TARGET_AVX2 inline Uint32 BoxSet::OutsideMaskAVX2(SDL_Rect rect, int first)
+{
+	Uint32 mask = 0;
+	__m256i x1 = _mm256_set1_epi32(rect.x), x2 = _mm256_set1_epi32(rect.x + rect.w);
+	__m256i y1 = _mm256_set1_epi32(rect.y), y2 = _mm256_set1_epi32(rect.y + rect.h);
+	for (int i = 0; i < Block; i += 8)
+	{
+		__m256i l = _mm256_loadu_si256((const __m256i*)&left[first + i]);
+		__m256i t = _mm256_loadu_si256((const __m256i*)&top[first + i]);
+		__m256i r = _mm256_loadu_si256((const __m256i*)&right[first + i]);
+		__m256i b = _mm256_loadu_si256((const __m256i*)&bottom[first + i]);
+		//Collided if the box starts before the rectangle ends and ends after the rectangle starts, on both axes.
+		__m256i m = _mm256_and_si256(_mm256_and_si256(_mm256_cmpgt_epi32(x2, l), _mm256_cmpgt_epi32(r, x1)),
+			_mm256_and_si256(_mm256_cmpgt_epi32(y2, t), _mm256_cmpgt_epi32(b, y1)));
+		mask |= (Uint32)_mm256_movemask_ps(_mm256_castsi256_ps(m)) << i;
+	}
+	return mask;
+}
+
+/*
+ * \brief Test 16 boxes for internal collision, 8 at a time.
+ */
+BOXSET_TARGET_AVX2 inline Uint32 BoxSet::InsideMaskAVX2(SDL_Rect rect, int first)
+{
+	Uint32 mask = 0;
+	__m256i x1 = _mm256_set1_epi32(rect.x), x2 = _mm256_set1_epi32(rect.x + rect.w);
+	__m256i y1 = _mm256_set1_epi32(rect.y), y2 = _mm256_set1_epi32(rect.y + rect.h);
+	for (int i = 0; i < Block; i += 8)
+	{
+		__m256i l = _mm256_loadu_si256((const __m256i*)&left[first + i]);
+		__m256i t = _mm256_loadu_si256((const __m256i*)&top[first + i]);
+		__m256i r = _mm256_loadu_si256((const __m256i*)&right[first + i]);
+		__m256i b = _mm256_loadu_si256((const __m256i*)&bottom[first + i]);
+		//The box sticks out of the rectangle.
+		__m256i out = _mm256_or_si256(_mm256_or_si256(_mm256_cmpgt_epi32(x1, l), _mm256_cmpgt_epi32(r, x2)),
+			_mm256_or_si256(_mm256_cmpgt_epi32(y1, t), _mm256_cmpgt_epi32(b, y2)));
+		//The rectangle sticks out of the box.
+		__m256i in = _mm256_or_si256(_mm256_or_si256(_mm256_cmpgt_epi32(l, x1), _mm256_cmpgt_epi32(x2, r)),
+			_mm256_or_si256(_mm256_cmpgt_epi32(t, y1), _mm256_cmpgt_epi32(y2, b)));
+		mask |= (Uint32)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_and_si256(out, in))) << i;
+	}
+	return mask;
+}
+#endif
+
+/*
+ * \brief Find all boxes colliding externally with a rectangle.
+ * \param rect The target rectangle.
+ * \param hits A vector to which the indices of colliding boxes are appended.
+ * \return The number of colliding boxes.
+ */
+inline int BoxSet::Overlapped(SDL_Rect rect, std::vector<int>& hits)
+{
+	int found = 0;
+	for (int first = 0; first < number; first += Block)
+	{
+		Uint32 mask = OutsideMask(rect, first);
+		for (int i = 0; mask != 0; i++, mask >>= 1)
+		{
+			if (mask & 1)
+			{
+				hits.push_back(first + i);
+				found++;
+			}
+		}
+	}
+	return found;
+}
+
+/*
+ * \brief Determine if the box set and a rectangle collide externally.
+ * \param rect The target rectangle.
+ * \return 1 if collided, or 0 if not collided.
+ */
+inline bool BoxSet::OutsideCollided(SDL_Rect rect)
+{
+	for (int first = 0; first < number; first += Block)
+		if (OutsideMask(rect, first) != 0)
+			return 1;
+	return 0;
+}
+
+/*
+ * \brief Determine if the box set and a rectangle collide internally.
+ * \param rect The target rectangle.
+ * \return 1 if collided, or 0 if not collided.
+ */
+inline bool BoxSet::InsideCollided(SDL_Rect rect)
+{
+	for (int first = 0; first < number; first += Block)
+		if (InsideMask(rect, first) != 0)
+			return 1;
+	return 0;
+}
+
+/*
+ * \brief Get the number of boxes in the set.
+ * \return The number of boxes.
+ */
+inline int BoxSet::Size()
+{
+	return number;
+}
+
+/*
+ * \brief Remove all boxes from the set.
+ */
+inline void BoxSet::free()
+{
+	std::vector<Sint32>().swap(left);
+	std::vector<Sint32>().swap(top);
+	std::vector<Sint32>().swap(right);
+	std::vector<Sint32>().swap(bottom);
+	number = 0;
+}
+
+
+#endif // !boxset_h_
\ No newline at end of file
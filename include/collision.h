@@ -4,6 +4,7 @@
 #include <math.h>
 #include <vector>
 #include <SDL.h>
+#include <profiler.h>
 
 //Circle wrapper class
 class Circle
@@ -31,7 +32,7 @@ inline double Distance(Circle a, Circle b)
  * \param rect1, rect2 The target rectangles.
  * \return 1 if collided, or 0 if not collided.
  */
-bool OutsideCollided(SDL_Rect rect1, SDL_Rect rect2)
+inline bool OutsideCollided(SDL_Rect rect1, SDL_Rect rect2)
 {
 	if (rect1.x + rect1.w <= rect2.x || rect2.x + rect2.w <= rect1.x || rect1.y + rect1.h <= rect2.y || rect2.y + rect2.h <= rect1.y)
 		return 0;
@@ -45,7 +46,7 @@ bool OutsideCollided(SDL_Rect rect1, SDL_Rect rect2)
  * \param rect The target rectangle.
  * \return 1 if collided, or 0 if not collided.
  */
-bool OutsideCollided(std::vector<SDL_Rect> A, SDL_Rect rect)
+inline bool OutsideCollided(const std::vector<SDL_Rect>& A, SDL_Rect rect)
 {
 	for (int i = 0; i < A.size(); i++)
 	{
@@ -60,8 +61,9 @@ bool OutsideCollided(std::vector<SDL_Rect> A, SDL_Rect rect)
  * \param A, B The target collision boxes.
  * \return 1 if collided, or 0 if not collided.
  */
-bool OutsideCollided(std::vector<SDL_Rect> A, std::vector<SDL_Rect> B)
+inline bool OutsideCollided(const std::vector<SDL_Rect>& A, const std::vector<SDL_Rect>& B)
 {
+	PROFILE_ZONE("OutsideCollided");
 	for (int i = 0; i < A.size(); i++)
 	{
 		for (int j = 0; j < B.size(); j++)
@@ -76,7 +78,7 @@ bool OutsideCollided(std::vector<SDL_Rect> A, std::vector<SDL_Rect> B)
  * \param rect1, rect2 The target rectangles.
  * \return 1 if collided, or 0 if not collided.
  */
-bool InsideCollided(SDL_Rect rect1, SDL_Rect rect2)
+inline bool InsideCollided(SDL_Rect rect1, SDL_Rect rect2)
 {
 	if (rect1.x >= rect2.x && rect1.x + rect1.w <= rect2.x + rect2.w && rect1.y >= rect2.y && rect1.y + rect1.h <= rect2.y + rect2.h)
 		return 0;
@@ -92,7 +94,7 @@ bool InsideCollided(SDL_Rect rect1, SDL_Rect rect2)
  * \param rect The target rectangle.
  * \return 1 if collided, or 0 if not collided.
  */
-bool InsideCollided(std::vector<SDL_Rect> A, SDL_Rect rect)
+inline bool InsideCollided(const std::vector<SDL_Rect>& A, SDL_Rect rect)
 {
 	for (int i = 0; i < A.size(); i++)
 	{
@@ -107,8 +109,9 @@ bool InsideCollided(std::vector<SDL_Rect> A, SDL_Rect rect)
  * \param A, B The target collision boxes.
  * \return 1 if collided, or 0 if not collided.
  */
-bool InsideCollided(std::vector<SDL_Rect> A, std::vector<SDL_Rect> B)
+inline bool InsideCollided(const std::vector<SDL_Rect>& A, const std::vector<SDL_Rect>& B)
 {
+	PROFILE_ZONE("InsideCollided");
 	for (int i = 0; i < A.size(); i++)
 	{
 		for (int j = 0; j < B.size(); j++)
@@ -118,5 +121,149 @@ bool InsideCollided(std::vector<SDL_Rect> A, std::vector<SDL_Rect> B)
 	return 0;
 }
 
+/*
+ * \brief Compute how far a rectangle can move in X direction before it collides externally with another one.
+ * \param rect The moving rectangle.
+ * \param dx The distance to move, negative for moving left.
+ * \param obstacle The still rectangle.
+ * \return The distance the rectangle can move, which has the same sign as (dx) and is not longer than it.
+ */
+inline int OutsideSweptX(SDL_Rect rect, int dx, SDL_Rect obstacle)
+{
+	//Rectangles which never meet on Y axis can't block each other.
+	if (rect.y + rect.h <= obstacle.y || obstacle.y + obstacle.h <= rect.y)
+		return dx;
+	//Empty rectangles never collide.
+	if (rect.w <= 0 || rect.h <= 0 || obstacle.w <= 0 || obstacle.h <= 0)
+		return dx;
+	//Stop right at the near edge of an obstacle lying ahead.
+	if (dx > 0 && obstacle.x >= rect.x + rect.w && obstacle.x - (rect.x + rect.w) < dx)
+		return obstacle.x - (rect.x + rect.w);
+	if (dx < 0 && obstacle.x + obstacle.w <= rect.x && obstacle.x + obstacle.w - rect.x > dx)
+		return obstacle.x + obstacle.w - rect.x;
+	return dx;
+}
+
+/*
+ * \brief Compute how far a rectangle can move in Y direction before it collides externally with another one.
+ * \param rect The moving rectangle.
+ * \param dy The distance to move, negative for moving up.
+ * \param obstacle The still rectangle.
+ * \return The distance the rectangle can move, which has the same sign as (dy) and is not longer than it.
+ */
+inline int OutsideSweptY(SDL_Rect rect, int dy, SDL_Rect obstacle)
+{
+	//Rectangles which never meet on X axis can't block each other.
+	if (rect.x + rect.w <= obstacle.x || obstacle.x + obstacle.w <= rect.x)
+		return dy;
+	//Empty rectangles never collide.
+	if (rect.w <= 0 || rect.h <= 0 || obstacle.w <= 0 || obstacle.h <= 0)
+		return dy;
+	//Stop right at the near edge of an obstacle lying ahead.
+	if (dy > 0 && obstacle.y >= rect.y + rect.h && obstacle.y - (rect.y + rect.h) < dy)
+		return obstacle.y - (rect.y + rect.h);
+	if (dy < 0 && obstacle.y + obstacle.h <= rect.y && obstacle.y + obstacle.h - rect.y > dy)
+		return obstacle.y + obstacle.h - rect.y;
+	return dy;
+}
+
+/*
+ * \brief Compute how far a set of collision boxes can move in X direction before it collides externally with another set.
+ * \param A The moving collision boxes.
+ * \param dx The distance to move, negative for moving left.
+ * \param B The still collision boxes.
+ * \return The distance the boxes can move, which has the same sign as (dx) and is not longer than it.
+ */
+inline int OutsideSweptX(const std::vector<SDL_Rect>& A, int dx, const std::vector<SDL_Rect>& B)
+{
+	PROFILE_ZONE("OutsideSweptX");
+	for (int i = 0; i < A.size() && dx != 0; i++)
+	{
+		for (int j = 0; j < B.size(); j++)
+			dx = OutsideSweptX(A[i], dx, B[j]);
+	}
+	return dx;
+}
+
+/*
+ * \brief Compute how far a set of collision boxes can move in Y direction before it collides externally with another set.
+ * \param A The moving collision boxes.
+ * \param dy The distance to move, negative for moving up.
+ * \param B The still collision boxes.
+ * \return The distance the boxes can move, which has the same sign as (dy) and is not longer than it.
+ */
+inline int OutsideSweptY(const std::vector<SDL_Rect>& A, int dy, const std::vector<SDL_Rect>& B)
+{
+	PROFILE_ZONE("OutsideSweptY");
+	for (int i = 0; i < A.size() && dy != 0; i++)
+	{
+		for (int j = 0; j < B.size(); j++)
+			dy = OutsideSweptY(A[i], dy, B[j]);
+	}
+	return dy;
+}
+
+/*
+ * \brief Compute how far a rectangle can move in X direction before it collides internally with a range.
+ * \param rect The moving rectangle.
+ * \param dx The distance to move, negative for moving left.
+ * \param range The still rectangle which should contain the moving one.
+ * \return The distance the rectangle can move, which has the same sign as (dx) and is not longer than it.
+ */
+inline int InsideSweptX(SDL_Rect rect, int dx, SDL_Rect range)
+{
+	//Stop right at the edge of the range, and never move further out if already outside.
+	if (dx > 0 && range.x + range.w - (rect.x + rect.w) < dx)
+		return range.x + range.w - (rect.x + rect.w) > 0 ? range.x + range.w - (rect.x + rect.w) : 0;
+	if (dx < 0 && range.x - rect.x > dx)
+		return range.x - rect.x < 0 ? range.x - rect.x : 0;
+	return dx;
+}
+
+/*
+ * \brief Compute how far a rectangle can move in Y direction before it collides internally with a range.
+ * \param rect The moving rectangle.
+ * \param dy The distance to move, negative for moving up.
+ * \param range The still rectangle which should contain the moving one.
+ * \return The distance the rectangle can move, which has the same sign as (dy) and is not longer than it.
+ */
+inline int InsideSweptY(SDL_Rect rect, int dy, SDL_Rect range)
+{
+	//Stop right at the edge of the range, and never move further out if already outside.
+	if (dy > 0 && range.y + range.h - (rect.y + rect.h) < dy)
+		return range.y + range.h - (rect.y + rect.h) > 0 ? range.y + range.h - (rect.y + rect.h) : 0;
+	if (dy < 0 && range.y - rect.y > dy)
+		return range.y - rect.y < 0 ? range.y - rect.y : 0;
+	return dy;
+}
+
+/*
+ * \brief Compute how far a set of collision boxes can move in X direction before it collides internally with a range.
+ * \param A The moving collision boxes.
+ * \param dx The distance to move, negative for moving left.
+ * \param range The still rectangle which should contain the moving boxes.
+ * \return The distance the boxes can move, which has the same sign as (dx) and is not longer than it.
+ */
+inline int InsideSweptX(const std::vector<SDL_Rect>& A, int dx, SDL_Rect range)
+{
+	for (int i = 0; i < A.size() && dx != 0; i++)
+		dx = InsideSweptX(A[i], dx, range);
+	return dx;
+}
+
+/*
+ * \brief Compute how far a set of collision boxes can move in Y direction before it collides internally with a range.
+ * \param A The moving collision boxes.
+ * \param dy The distance to move, negative for moving up.
+ * \param range The still rectangle which should contain the moving boxes.
+ * \return The distance the boxes can move, which has the same sign as (dy) and is not longer than it.
+ */
+inline int InsideSweptY(const std::vector<SDL_Rect>& A, int dy, SDL_Rect range)
+{
+	for (int i = 0; i < A.size() && dy != 0; i++)
+		dy = InsideSweptY(A[i], dy, range);
+	return dy;
+}
+
 
 #endif // !collision_h_
\ No newline at end of file
@@ -0,0 +1,375 @@
+#ifndef dirty_h_
+#define dirty_h_
+
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <SDL.h>
+
+//Dirty region wrapper class
+class DirtyRegion
+{
+private:
+	//Rects marked since the last merge, and the merged rects being redrawn.
+	std::vector<SDL_Rect> rects;
+	std::vector<SDL_Rect> merged;
+	SDL_Rect bounds;
+	int MaxRects;
+	const SDL_Rect* current;
+	//Whether drawing is only recording where it would go, before the frame is merged.
+	bool tracking;
+	//The places drawn by every tracked owner in the last frame, and in the frame being tracked.
+	struct Footprints
+	{
+		std::vector<SDL_Rect> previous;
+		std::vector<SDL_Rect> current;
+	};
+	std::unordered_map<const void*, Footprints> footprints;
+	static Sint64 Area(const SDL_Rect& rect);
+	static bool Less(const SDL_Rect& a, const SDL_Rect& b);
+	void MarkChanged(Footprints& prints);
+public:
+	DirtyRegion();
+	~DirtyRegion();
+	void Init(int w, int h, int MaxRects = 8);
+	void Mark(SDL_Rect rect);
+	void MarkAll();
+	bool IsDirty();
+	int GetMaxRects();
+	const std::vector<SDL_Rect>& Merge();
+	void SetCurrent(const SDL_Rect* rect);
+	bool Visible(const SDL_Rect& rect);
+	void StartTracking();
+	void FinishTracking();
+	bool Track(const void* owner, SDL_Rect rect);
+	void Invalidate(const void* owner);
+	void Forget(const void* owner);
+	void Clear();
+	void free();
+};
+
+/*
+ * \brief Create an empty dirty region.
+ */
+inline DirtyRegion::DirtyRegion()
+{
+	bounds = { 0,0,0,0 };
+	MaxRects = 8;
+	current = NULL;
+	tracking = false;
+}
+
+/*
+ * \brief Deallocate the dirty region.
+ */
+inline DirtyRegion::~DirtyRegion()
+{
+	free();
+}
+
+/*
+ * \brief Start tracking a screen, which is entirely dirty at first.
+ * \param w The width of the screen.
+ * \param h The height of the screen.
+ * \param MaxRects The largest number of rects redrawn in a frame.
+ */
+inline void DirtyRegion::Init(int w, int h, int MaxRects)
+{
+	free();
+	bounds = { 0,0,w,h };
+	this->MaxRects = MaxRects > 0 ? MaxRects : 1;
+	MarkAll();
+}
+
+/*
+ * \brief Mark a part of the screen to be redrawn.
+ * \param rect The changed part in screen coordinates.
+ */
+inline void DirtyRegion::Mark(SDL_Rect rect)
+{
+	SDL_Rect clipped;
+	if (SDL_IntersectRect(&rect, &bounds, &clipped))
+		rects.push_back(clipped);
+}
+
+/*
+ * \brief Mark the whole screen to be redrawn.
+ */
+inline void DirtyRegion::MarkAll()
+{
+	rects.clear();
+	if (bounds.w > 0 && bounds.h > 0)
+		rects.push_back(bounds);
+}
+
+/*
+ * \brief Determine if anything has been marked since the last merge.
+ * \return 1 if dirty, or 0 if the screen is unchanged.
+ */
+inline bool DirtyRegion::IsDirty()
+{
+	return !rects.empty();
+}
+
+/*
+ * \brief Get the largest number of rects redrawn in a frame.
+ * \return The number of rects.
+ */
+inline int DirtyRegion::GetMaxRects()
+{
+	return MaxRects;
+}
+
+/*
+ * \brief Get the area of a rect.
+ */
+inline Sint64 DirtyRegion::Area(const SDL_Rect& rect)
+{
+	return (Sint64)rect.w * rect.h;
+}
+
+/*
+ * \brief Merge the marked rects into a few rects to be redrawn. Rects marked afterwards belong to the next frame.
+ * \return A vector containing at most MaxRects rects.
+ */
+inline const std::vector<SDL_Rect>& DirtyRegion::Merge()
+{
+	merged.swap(rects);
+	rects.clear();
+	//Many small rects are cheaper to redraw as their bounding box than to merge.
+	if (merged.size() > 256)
+	{
+		for (int i = 1; i < merged.size(); i++)
+			SDL_UnionRect(&merged[0], &merged[i], &merged[0]);
+		merged.resize(1);
+	}
+	//Merge rects whose union is no larger than themselves, such as overlapping or adjacent ones.
+	bool changed = true;
+	while (changed)
+	{
+		changed = false;
+		for (int i = 0; i < merged.size() && !changed; i++)
+			for (int j = i + 1; j < merged.size(); j++)
+			{
+				SDL_Rect united;
+				SDL_UnionRect(&merged[i], &merged[j], &united);
+				if (Area(united) <= Area(merged[i]) + Area(merged[j]))
+				{
+					merged[i] = united;
+					merged[j] = merged.back();
+					merged.pop_back();
+					changed = true;
+					break;
+				}
+			}
+	}
+	//Merge the pairs wasting the least area until few enough rects are left.
+	while (merged.size() > MaxRects)
+	{
+		int first = 0, second = 1;
+		Sint64 waste = -1;
+		SDL_Rect best;
+		for (int i = 0; i < merged.size(); i++)
+			for (int j = i + 1; j < merged.size(); j++)
+			{
+				SDL_Rect united;
+				SDL_UnionRect(&merged[i], &merged[j], &united);
+				Sint64 extra = Area(united) - Area(merged[i]) - Area(merged[j]);
+				if (waste < 0 || extra < waste)
+				{
+					waste = extra;
+					first = i;
+					second = j;
+					best = united;
+				}
+			}
+		merged[first] = best;
+		merged[second] = merged.back();
+		merged.pop_back();
+	}
+	return merged;
+}
+
+/*
+ * \brief Set the rect being redrawn, outside which drawing is skipped.
+ * \param rect One of the merged rects, or NULL to draw everywhere.
+ */
+inline void DirtyRegion::SetCurrent(const SDL_Rect* rect)
+{
+	current = rect;
+}
+
+/*
+ * \brief Determine if something drawn at a place would show in the rect being redrawn.
+ * \param rect The destination of drawing in screen coordinates.
+ * \return 1 if it should be drawn, or 0 if it can be skipped.
+ */
+inline bool DirtyRegion::Visible(const SDL_Rect& rect)
+{
+	return !tracking && (current == NULL || SDL_HasIntersection(&rect, current));
+}
+
+/*
+ * \brief Order rects by position and then by size, so that footprints can be compared in one pass.
+ */
+inline bool DirtyRegion::Less(const SDL_Rect& a, const SDL_Rect& b)
+{
+	if (a.y != b.y)
+		return a.y < b.y;
+	if (a.x != b.x)
+		return a.x < b.x;
+	if (a.w != b.w)
+		return a.w < b.w;
+	return a.h < b.h;
+}
+
+/*
+ * \brief Start a pass which records where owners draw without drawing anything, since nothing is visible meanwhile.
+ */
+inline void DirtyRegion::StartTracking()
+{
+	tracking = true;
+}
+
+/*
+ * \brief Finish the recording pass, and mark the places where owners appeared or disappeared since the last pass,
+ * so that they are redrawn in the frame being merged.
+ */
+inline void DirtyRegion::FinishTracking()
+{
+	tracking = false;
+	for (auto it = footprints.begin(); it != footprints.end();)
+	{
+		MarkChanged(it->second);
+		if (it->second.previous.empty())
+			it = footprints.erase(it);
+		else
+			it++;
+	}
+}
+
+/*
+ * \brief Record a place where an owner draws in the recording pass, or determine if it shows in the rect being redrawn.
+ * \param owner The drawing object, such as a texture drawn at several places.
+ * \param rect The destination of drawing in screen coordinates.
+ * \return 1 if it should be drawn, or 0 if it can be skipped.
+ */
+inline bool DirtyRegion::Track(const void* owner, SDL_Rect rect)
+{
+	if (tracking)
+		footprints[owner].current.push_back(rect);
+	return Visible(rect);
+}
+
+/*
+ * \brief Mark every place where an owner was drawn, such as after its pixels or color change.
+ * \param owner The drawing object.
+ */
+inline void DirtyRegion::Invalidate(const void* owner)
+{
+	auto found = footprints.find(owner);
+	if (found == footprints.end())
+		return;
+	for (int i = 0; i < found->second.previous.size(); i++)
+		Mark(found->second.previous[i]);
+	for (int i = 0; i < found->second.current.size(); i++)
+		Mark(found->second.current[i]);
+}
+
+/*
+ * \brief Mark every place where an owner was drawn, and stop tracking it, such as when it is destroyed.
+ * \param owner The drawing object.
+ */
+inline void DirtyRegion::Forget(const void* owner)
+{
+	Invalidate(owner);
+	footprints.erase(owner);
+}
+
+/*
+ * \brief Mark the places drawn in only one of the last frame and this frame, and make this frame the last one.
+ */
+inline void DirtyRegion::MarkChanged(Footprints& prints)
+{
+	std::sort(prints.current.begin(), prints.current.end(), Less);
+	prints.current.erase(std::unique(prints.current.begin(), prints.current.end(), [](const SDL_Rect& a, const SDL_Rect& b)
+		{
+			return !Less(a, b) && !Less(b, a);
+		}), prints.current.end());
+	int i = 0, j = 0;
+	while (i < prints.previous.size() || j < prints.current.size())
+	{
+		if (j == prints.current.size() || (i < prints.previous.size() && Less(prints.previous[i], prints.current[j])))
+			Mark(prints.previous[i++]);
+		else if (i == prints.previous.size() || Less(prints.current[j], prints.previous[i]))
+			Mark(prints.current[j++]);
+		else
+		{
+			i++;
+			j++;
+		}
+	}
+	prints.previous.swap(prints.current);
+	prints.current.clear();
+}
+
+/*
+ * \brief Forget the merged rects after they have been redrawn.
+ */
+inline void DirtyRegion::Clear()
+{
+	merged.clear();
+	current = NULL;
+}
+
+/*
+ * \brief Deallocate the dirty region.
+ */
+inline void DirtyRegion::free()
+{
+	std::vector<SDL_Rect>().swap(rects);
+	std::vector<SDL_Rect>().swap(merged);
+	std::unordered_map<const void*, Footprints>().swap(footprints);
+	current = NULL;
+	tracking = false;
+}
+
+/*
+ * \brief Get the dirty regions of renderers which draw with dirty rects.
+ * \return The map from renderers to their dirty regions.
+ */
+inline std::unordered_map<SDL_Renderer*, DirtyRegion*>& GetDirtyRegions()
+{
+	static std::unordered_map<SDL_Renderer*, DirtyRegion*> regions;
+	return regions;
+}
+
+/*
+ * \brief Get the dirty region of a renderer.
+ * \param renderer The renderer which textures draw on.
+ * \return The dirty region, or NULL if the renderer redraws everything.
+ */
+inline DirtyRegion* GetDirtyRegion(SDL_Renderer* renderer)
+{
+	std::unordered_map<SDL_Renderer*, DirtyRegion*>& regions = GetDirtyRegions();
+	if (regions.empty())
+		return NULL;
+	auto found = regions.find(renderer);
+	return found == regions.end() ? NULL : found->second;
+}
+
+/*
+ * \brief Set the dirty region of a renderer.
+ * \param renderer The renderer which textures draw on.
+ * \param region The dirty region, or NULL to redraw everything.
+ */
+inline void SetDirtyRegion(SDL_Renderer* renderer, DirtyRegion* region)
+{
+	if (region == NULL)
+		GetDirtyRegions().erase(renderer);
+	else
+		GetDirtyRegions()[renderer] = region;
+}
+
+
+#endif // !dirty_h_
\ No newline at end of file
@@ -0,0 +1,745 @@
+#ifndef entity_h_
+#define entity_h_
+
+#include <math.h>
+#include <memory>
+#include <vector>
+#include <SDL.h>
+#include <collision.h>
+#include <aabbtree.h>
+#include <texture.h>
+#include <dirty.h>
+#include <renderqueue.h>
+#include <jobs.h>
+#include <profiler.h>
+#include <error.h>
+
+//A stable reference to an entity, which turns invalid once the entity is destroyed.
+struct EntityHandle
+{
+	int slot;
+	Uint32 generation;
+};
+
+//Entity store wrapper class
+class EntityStore
+{
+	friend class Entity;
+private:
+	SDL_Renderer* rend;
+	std::vector<std::shared_ptr<Texture>> table;
+	//Arrays of entities, one element an entity, which stay packed when entities are destroyed.
+	std::vector<int> x, y;
+	//The positions before the last move, from which rendering is interpolated.
+	std::vector<int> prev_x, prev_y;
+	std::vector<int> velocity_x, velocity_y;
+	std::vector<SDL_Rect> ranges;
+	//The portions of textures, where a width of 0 stands for the entire texture.
+	std::vector<SDL_Rect> clips;
+	std::vector<int> textures;
+	//The collision boxes of an entity, as a span of offsets.
+	std::vector<int> BoxFirst, BoxCount;
+	//The screen areas covered by the last drawing.
+	std::vector<SDL_Rect> shown;
+	std::vector<int> owners;
+	//Collision boxes relative to positions, for all entities, including the ones of destroyed entities until collected.
+	std::vector<SDL_Rect> offsets;
+	int garbage;
+	//Slots of handles, mapping to the arrays of entities.
+	std::vector<int> dense;
+	std::vector<Uint32> generations;
+	std::vector<int> vacant;
+	//The offset from positions to the screen in the last rendering, such as the opposite of the camera.
+	SDL_Point offset;
+	int drawn;
+	int Find(EntityHandle handle);
+	SDL_Point Size(int index);
+	SDL_Rect Bound(int index, SDL_Point offset, double alpha);
+	bool Fits(int index, AABBTree* obstacles);
+	void Step(int first, int last, AABBTree* obstacles);
+	void MarkMoved();
+	void Draw(SDL_Point offset, double alpha, SDL_Rect* view);
+	void Collect();
+public:
+	EntityStore();
+	~EntityStore();
+	void Init(SDL_Renderer* renderer);
+	int AddTexture(std::shared_ptr<Texture> texture);
+	EntityHandle Create(int texture, SDL_Point point, SDL_Rect range, const std::vector<SDL_Rect>& boxes, SDL_Rect* clip = NULL);
+	void Destroy(EntityHandle handle);
+	bool IsValid(EntityHandle handle);
+	int Size();
+	void Reserve(int entities, int boxes);
+	void Move();
+	void Move(AABBTree& obstacles);
+	void Move(JobSystem& jobs);
+	void Move(JobSystem& jobs, AABBTree& obstacles);
+	void MarkMoved(SDL_Point offset, double alpha);
+	void Render();
+	void Render(SDL_Rect& camera);
+	void Render(double alpha);
+	void Render(SDL_Rect& camera, double alpha);
+	int GetDrawn();
+	void free();
+};
+
+//Entity wrapper class, a view of an entity in a store with the interface of MovableTexture.
+class Entity
+{
+private:
+	EntityStore* store;
+	EntityHandle handle;
+public:
+	Entity();
+	Entity(EntityStore& store, EntityHandle handle);
+	bool IsValid();
+	EntityHandle GetHandle();
+	SDL_Point GetPosition();
+	void SetPosition(SDL_Point point);
+	SDL_Point GetVelocity();
+	void SetVelocity(int vx, int vy);
+	void HandleEvent(const SDL_Event& event);
+	void CameraFollow(SDL_Rect& camera);
+	void Destroy();
+};
+
+/*
+ * \brief Create an empty entity store.
+ */
+inline EntityStore::EntityStore()
+{
+	rend = NULL;
+	garbage = 0;
+	offset = { 0,0 };
+	drawn = 0;
+}
+
+/*
+ * \brief Deallocate the entity store.
+ */
+inline EntityStore::~EntityStore()
+{
+	free();
+}
+
+/*
+ * \brief Start storing entities drawn by a renderer.
+ * \param renderer The renderer which should draw the entities.
+ */
+inline void EntityStore::Init(SDL_Renderer* renderer)
+{
+	free();
+	rend = renderer;
+}
+
+/*
+ * \brief Add a texture which entities can show.
+ * \param texture The shared texture, such as one from a texture cache, created on the renderer of the store.
+ * \return The number of the texture.
+ */
+inline int EntityStore::AddTexture(std::shared_ptr<Texture> texture)
+{
+	table.push_back(std::move(texture));
+	return (int)table.size() - 1;
+}
+
+/*
+ * \brief Create an entity.
+ * \param texture The number of the texture showing the entity, or -1 for an invisible entity.
+ * \param point The initial position.
+ * \param range The scope of activity of the entity.
+ * \param boxes The collision boxes of the entity, relative to its position.
+ * \param clip A pointer to the portion of the texture, or NULL for the entire texture.
+ * \return The handle of the entity.
+ */
+inline EntityHandle EntityStore::Create(int texture, SDL_Point point, SDL_Rect range, const std::vector<SDL_Rect>& boxes, SDL_Rect* clip)
+{
+	int slot;
+	if (vacant.empty())
+	{
+		slot = (int)dense.size();
+		dense.push_back(-1);
+		generations.push_back(0);
+	}
+	else
+	{
+		slot = vacant.back();
+		vacant.pop_back();
+	}
+	dense[slot] = (int)x.size();
+	x.push_back(point.x);
+	y.push_back(point.y);
+	prev_x.push_back(point.x);
+	prev_y.push_back(point.y);
+	velocity_x.push_back(0);
+	velocity_y.push_back(0);
+	ranges.push_back(range);
+	clips.push_back(clip != NULL ? *clip : SDL_Rect{ 0,0,0,0 });
+	textures.push_back(texture);
+	BoxFirst.push_back((int)offsets.size());
+	BoxCount.push_back((int)boxes.size());
+	offsets.insert(offsets.end(), boxes.begin(), boxes.end());
+	shown.push_back({ 0,0,0,0 });
+	owners.push_back(slot);
+	return { slot,generations[slot] };
+}
+
+/*
+ * \brief Destroy an entity. The last entity takes its place, so that the arrays stay packed.
+ * \param handle The handle of the entity, which turns invalid.
+ */
+inline void EntityStore::Destroy(EntityHandle handle)
+{
+	int index = Find(handle);
+	if (index < 0)
+		return;
+	DirtyRegion* dirty = GetDirtyRegion(rend);
+	if (dirty != NULL)
+		dirty->Mark(shown[index]);
+	garbage += BoxCount[index];
+	int last = (int)x.size() - 1;
+	x[index] = x[last];
+	y[index] = y[last];
+	prev_x[index] = prev_x[last];
+	prev_y[index] = prev_y[last];
+	velocity_x[index] = velocity_x[last];
+	velocity_y[index] = velocity_y[last];
+	ranges[index] = ranges[last];
+	clips[index] = clips[last];
+	textures[index] = textures[last];
+	BoxFirst[index] = BoxFirst[last];
+	BoxCount[index] = BoxCount[last];
+	shown[index] = shown[last];
+	owners[index] = owners[last];
+	dense[owners[index]] = index;
+	x.pop_back();
+	y.pop_back();
+	prev_x.pop_back();
+	prev_y.pop_back();
+	velocity_x.pop_back();
+	velocity_y.pop_back();
+	ranges.pop_back();
+	clips.pop_back();
+	textures.pop_back();
+	BoxFirst.pop_back();
+	BoxCount.pop_back();
+	shown.pop_back();
+	owners.pop_back();
+	dense[handle.slot] = -1;
+	generations[handle.slot]++;
+	vacant.push_back(handle.slot);
+	//Drop the boxes of destroyed entities once they take up half of all boxes.
+	if (garbage * 2 > (int)offsets.size())
+		Collect();
+}
+
+/*
+ * \brief Pack the collision boxes of living entities in their order.
+ */
+inline void EntityStore::Collect()
+{
+	std::vector<SDL_Rect> packed;
+	packed.reserve(offsets.size() - garbage);
+	for (int i = 0; i < x.size(); i++)
+	{
+		int first = (int)packed.size();
+		packed.insert(packed.end(), offsets.begin() + BoxFirst[i], offsets.begin() + BoxFirst[i] + BoxCount[i]);
+		BoxFirst[i] = first;
+	}
+	offsets.swap(packed);
+	garbage = 0;
+}
+
+/*
+ * \brief Find an entity in the arrays.
+ * \return The index of the entity, or -1 if the handle is invalid.
+ */
+inline int EntityStore::Find(EntityHandle handle)
+{
+	if (handle.slot < 0 || handle.slot >= dense.size() || generations[handle.slot] != handle.generation)
+		return -1;
+	return dense[handle.slot];
+}
+
+/*
+ * \brief Determine if an entity is still alive.
+ * \param handle The handle of the entity.
+ * \return 1 if alive, or 0 if destroyed.
+ */
+inline bool EntityStore::IsValid(EntityHandle handle)
+{
+	return Find(handle) >= 0;
+}
+
+/*
+ * \brief Get the number of living entities.
+ * \return The number of entities.
+ */
+inline int EntityStore::Size()
+{
+	return (int)x.size();
+}
+
+/*
+ * \brief Allocate the arrays in advance, so that creating entities doesn't allocate.
+ * \param entities The number of entities.
+ * \param boxes The number of collision boxes of all entities.
+ */
+inline void EntityStore::Reserve(int entities, int boxes)
+{
+	x.reserve(entities);
+	y.reserve(entities);
+	prev_x.reserve(entities);
+	prev_y.reserve(entities);
+	velocity_x.reserve(entities);
+	velocity_y.reserve(entities);
+	ranges.reserve(entities);
+	clips.reserve(entities);
+	textures.reserve(entities);
+	BoxFirst.reserve(entities);
+	BoxCount.reserve(entities);
+	shown.reserve(entities);
+	owners.reserve(entities);
+	dense.reserve(entities);
+	generations.reserve(entities);
+	offsets.reserve(boxes);
+}
+
+/*
+ * \brief Get the size in which an entity is drawn.
+ * \return The width and height.
+ */
+inline SDL_Point EntityStore::Size(int index)
+{
+	if (clips[index].w != 0)
+		return { clips[index].w,clips[index].h };
+	if (textures[index] < 0)
+		return { 0,0 };
+	return { table[textures[index]]->GetWidth(),table[textures[index]]->GetHeight() };
+}
+
+/*
+ * \brief Determine if the collision boxes of an entity at its position stay in its range and clear of obstacles.
+ * \param obstacles The static collision boxes, or NULL for none.
+ * \return 1 if it fits, or 0 if collided.
+ */
+inline bool EntityStore::Fits(int index, AABBTree* obstacles)
+{
+	//Boxes are placed on the fly, instead of being rewritten on every move.
+	for (int i = BoxFirst[index]; i < BoxFirst[index] + BoxCount[index]; i++)
+	{
+		SDL_Rect box = { x[index] + offsets[i].x,y[index] + offsets[i].y,offsets[i].w,offsets[i].h };
+		if (InsideCollided(box, ranges[index]))
+			return 0;
+		if (obstacles != NULL && obstacles->OutsideCollided(box))
+			return 0;
+	}
+	return 1;
+}
+
+/*
+ * \brief Move a span of entities according to their velocities, touching nothing but their own elements.
+ * \param first The index of the first entity.
+ * \param last The index after the last entity.
+ * \param obstacles The static collision boxes, or NULL for none.
+ */
+inline void EntityStore::Step(int first, int last, AABBTree* obstacles)
+{
+	for (int i = first; i < last; i++)
+	{
+		prev_x[i] = x[i];
+		prev_y[i] = y[i];
+		//Move in X direction.
+		if (velocity_x[i] != 0)
+		{
+			x[i] += velocity_x[i];
+			if (!Fits(i, obstacles))
+				x[i] -= velocity_x[i];
+		}
+		//Move in Y direction.
+		if (velocity_y[i] != 0)
+		{
+			y[i] += velocity_y[i];
+			if (!Fits(i, obstacles))
+				y[i] -= velocity_y[i];
+		}
+	}
+}
+
+/*
+ * \brief Mark the areas before and after the moves dirty, so that the moves are redrawn in the same frame.
+ */
+inline void EntityStore::MarkMoved()
+{
+	DirtyRegion* dirty = GetDirtyRegion(rend);
+	if (dirty == NULL)
+		return;
+	for (int i = 0; i < x.size(); i++)
+	{
+		if (x[i] != prev_x[i] || y[i] != prev_y[i])
+		{
+			SDL_Point size = Size(i);
+			dirty->Mark(shown[i]);
+			dirty->Mark({ prev_x[i] + offset.x,prev_y[i] + offset.y,size.x,size.y });
+			dirty->Mark({ x[i] + offset.x,y[i] + offset.y,size.x,size.y });
+		}
+	}
+}
+
+/*
+ * \brief Move all entities according to their velocities.
+ */
+inline void EntityStore::Move()
+{
+	PROFILE_ZONE("EntityStore::Move");
+	Step(0, (int)x.size(), NULL);
+	MarkMoved();
+}
+
+/*
+ * \brief Move all entities according to their velocities, and stop them in front of static obstacles.
+ * \param obstacles The static collision boxes which entities can't pass through.
+ */
+inline void EntityStore::Move(AABBTree& obstacles)
+{
+	PROFILE_ZONE("EntityStore::Move");
+	Step(0, (int)x.size(), &obstacles);
+	MarkMoved();
+}
+
+/*
+ * \brief Move all entities according to their velocities on all threads of a job system.
+ * \param jobs The job system running the moves.
+ */
+inline void EntityStore::Move(JobSystem& jobs)
+{
+	PROFILE_ZONE("EntityStore::Move");
+	jobs.ParallelFor((int)x.size(), 256, [this](int first, int last) { Step(first, last, NULL); });
+	MarkMoved();
+}
+
+/*
+ * \brief Move all entities on all threads of a job system, and stop them in front of static obstacles.
+ * The obstacles are only read while moving, so the threads share them.
+ * \param jobs The job system running the moves.
+ * \param obstacles The static collision boxes which entities can't pass through.
+ */
+inline void EntityStore::Move(JobSystem& jobs, AABBTree& obstacles)
+{
+	PROFILE_ZONE("EntityStore::Move");
+	jobs.ParallelFor((int)x.size(), 256, [this, &obstacles](int first, int last) { Step(first, last, &obstacles); });
+	MarkMoved();
+}
+
+/*
+ * \brief Draw the entities in their order, skipping the ones outside the view and the ones outside the rect being redrawn.
+ * \param offset The offset from positions to the screen.
+ * \param alpha How far from the positions before the last move to the current positions.
+ * \param view A pointer to the visible screen area, or NULL to draw all entities.
+ */
+inline void EntityStore::Draw(SDL_Point offset, double alpha, SDL_Rect* view)
+{
+	PROFILE_ZONE("EntityStore::Render");
+	this->offset = offset;
+	drawn = 0;
+	DirtyRegion* dirty = GetDirtyRegion(rend);
+	RenderQueue* queue = GetRenderQueue(rend);
+	for (int i = 0; i < x.size(); i++)
+	{
+		if (textures[i] < 0)
+			continue;
+		SDL_Rect bound = Bound(i, offset, alpha);
+		shown[i] = bound;
+		if (view != NULL && !SDL_HasIntersection(&bound, view))
+			continue;
+		if (dirty != NULL && !dirty->Visible(bound))
+			continue;
+		Texture& texture = *table[textures[i]];
+		if (queue != NULL)
+			queue->Copy(texture.GetTexture(), clips[i].w != 0 ? &clips[i] : NULL, &bound);
+		else if (SDL_RenderCopy(rend, texture.GetTexture(), clips[i].w != 0 ? &clips[i] : NULL, &bound) != 0)
+			SDL_ReportError("SDL_RenderCopy");
+		drawn++;
+	}
+}
+
+/*
+ * \brief Get the screen area of an entity drawn between its last two positions.
+ */
+inline SDL_Rect EntityStore::Bound(int index, SDL_Point offset, double alpha)
+{
+	SDL_Point size = Size(index);
+	SDL_Rect bound = { x[index] + offset.x,y[index] + offset.y,size.x,size.y };
+	if (alpha < 1)
+	{
+		bound.x = prev_x[index] + (int)lround((x[index] - prev_x[index]) * alpha) + offset.x;
+		bound.y = prev_y[index] + (int)lround((y[index] - prev_y[index]) * alpha) + offset.y;
+	}
+	return bound;
+}
+
+/*
+ * \brief Mark the areas where entities were last drawn and will be drawn next, before Window::Redraw merges the dirty rects.
+ * Interpolated positions and cameras change without a move, so call it before every redraw which renders with them.
+ * \param offset The offset from positions to the screen, such as the opposite of the camera.
+ * \param alpha How far from the positions before the last move to the current positions, such as FixedLoop::Alpha().
+ */
+inline void EntityStore::MarkMoved(SDL_Point offset, double alpha)
+{
+	DirtyRegion* dirty = GetDirtyRegion(rend);
+	if (dirty == NULL)
+		return;
+	//Track every entity on its own, since many entities share a texture.
+	for (int i = 0; i < x.size(); i++)
+	{
+		if (textures[i] < 0)
+			continue;
+		SDL_Rect bound = Bound(i, offset, alpha);
+		if (bound.x != shown[i].x || bound.y != shown[i].y || bound.w != shown[i].w || bound.h != shown[i].h)
+		{
+			dirty->Mark(shown[i]);
+			dirty->Mark(bound);
+		}
+	}
+}
+
+/*
+ * \brief Show all entities on the renderer.
+ */
+inline void EntityStore::Render()
+{
+	Draw({ 0,0 }, 1, NULL);
+}
+
+/*
+ * \brief Show the entities in front of a camera, skipping the ones it doesn't shoot.
+ * \param camera The camera which shoots the entities.
+ */
+inline void EntityStore::Render(SDL_Rect& camera)
+{
+	SDL_Rect view = { 0,0,camera.w,camera.h };
+	Draw({ -camera.x,-camera.y }, 1, &view);
+}
+
+/*
+ * \brief Show all entities between their last two positions. With dirty rects, call MarkMoved({ 0,0 }, alpha) before redrawing.
+ * \param alpha How far from the positions before the last move to the current positions, such as FixedLoop::Alpha().
+ */
+inline void EntityStore::Render(double alpha)
+{
+	Draw({ 0,0 }, alpha, NULL);
+}
+
+/*
+ * \brief Show the entities between their last two positions in front of a camera, skipping the ones it doesn't shoot.
+ * With dirty rects, call MarkMoved({ -camera.x,-camera.y }, alpha) before redrawing.
+ * \param camera The camera which shoots the entities.
+ * \param alpha How far from the positions before the last move to the current positions, such as FixedLoop::Alpha().
+ */
+inline void EntityStore::Render(SDL_Rect& camera, double alpha)
+{
+	SDL_Rect view = { 0,0,camera.w,camera.h };
+	Draw({ -camera.x,-camera.y }, alpha, &view);
+}
+
+/*
+ * \brief Get the number of entities drawn by the last rendering.
+ * \return The number of entities.
+ */
+inline int EntityStore::GetDrawn()
+{
+	return drawn;
+}
+
+/*
+ * \brief Destroy all entities and forget the textures. Handles from before turn invalid.
+ */
+inline void EntityStore::free()
+{
+	//Keep the generations, so that old handles never match a new entity.
+	for (int i = 0; i < dense.size(); i++)
+	{
+		if (dense[i] >= 0)
+		{
+			dense[i] = -1;
+			generations[i]++;
+			vacant.push_back(i);
+		}
+	}
+	table.clear();
+	x.clear();
+	y.clear();
+	prev_x.clear();
+	prev_y.clear();
+	velocity_x.clear();
+	velocity_y.clear();
+	ranges.clear();
+	clips.clear();
+	textures.clear();
+	BoxFirst.clear();
+	BoxCount.clear();
+	shown.clear();
+	owners.clear();
+	offsets.clear();
+	garbage = 0;
+	offset = { 0,0 };
+	drawn = 0;
+	rend = NULL;
+}
+
+/*
+ * \brief Create a view of no entity.
+ */
+inline Entity::Entity()
+{
+	store = NULL;
+	handle = { -1,0 };
+}
+
+/*
+ * \brief Create a view of an entity.
+ * \param store The store holding the entity.
+ * \param handle The handle of the entity.
+ */
+inline Entity::Entity(EntityStore& store, EntityHandle handle)
+{
+	this->store = &store;
+	this->handle = handle;
+}
+
+/*
+ * \brief Determine if the entity is still alive.
+ * \return 1 if alive, or 0 if destroyed.
+ */
+inline bool Entity::IsValid()
+{
+	return store != NULL && store->IsValid(handle);
+}
+
+/*
+ * \brief Get the handle of the entity.
+ * \return The handle.
+ */
+inline EntityHandle Entity::GetHandle()
+{
+	return handle;
+}
+
+/*
+ * \brief Get the position of the entity.
+ * \return The position, or (0, 0) if the entity is destroyed.
+ */
+inline SDL_Point Entity::GetPosition()
+{
+	int index = store != NULL ? store->Find(handle) : -1;
+	if (index < 0)
+		return { 0,0 };
+	return { store->x[index],store->y[index] };
+}
+
+/*
+ * \brief Place the entity somewhere without moving through the way, which isn't interpolated.
+ * \param point The new position.
+ */
+inline void Entity::SetPosition(SDL_Point point)
+{
+	int index = store != NULL ? store->Find(handle) : -1;
+	if (index < 0)
+		return;
+	store->x[index] = point.x;
+	store->y[index] = point.y;
+	store->prev_x[index] = point.x;
+	store->prev_y[index] = point.y;
+}
+
+/*
+ * \brief Get the velocity of the entity.
+ * \return The velocity in X and Y directions, or (0, 0) if the entity is destroyed.
+ */
+inline SDL_Point Entity::GetVelocity()
+{
+	int index = store != NULL ? store->Find(handle) : -1;
+	if (index < 0)
+		return { 0,0 };
+	return { store->velocity_x[index],store->velocity_y[index] };
+}
+
+/*
+ * \brief Set the velocity of the entity.
+ * \param vx The velocity in X direction.
+ * \param vy The velocity in Y direction.
+ */
+inline void Entity::SetVelocity(int vx, int vy)
+{
+	int index = store != NULL ? store->Find(handle) : -1;
+	if (index < 0)
+		return;
+	store->velocity_x[index] = vx;
+	store->velocity_y[index] = vy;
+}
+
+/*
+ * \brief Handle movement events, like MovableTexture::HandleEvent.
+ * \param event The event to be handled.
+ */
+inline void Entity::HandleEvent(const SDL_Event& event)
+{
+	int index = store != NULL ? store->Find(handle) : -1;
+	if (index < 0 || (event.type != SDL_KEYDOWN && event.type != SDL_KEYUP) || event.key.repeat != 0)
+		return;
+	SDL_Point size = store->Size(index);
+	//A pressed key adds to the velocity on the corresponding direction, and a released key restores it.
+	int sign = event.type == SDL_KEYDOWN ? 1 : -1;
+	switch (event.key.keysym.sym)
+	{
+		case SDLK_w:
+			store->velocity_y[index] -= sign * (size.y / 10);
+			break;
+		case SDLK_s:
+			store->velocity_y[index] += sign * (size.y / 10);
+			break;
+		case SDLK_a:
+			store->velocity_x[index] -= sign * (size.x / 10);
+			break;
+		case SDLK_d:
+			store->velocity_x[index] += sign * (size.x / 10);
+			break;
+	}
+}
+
+/*
+ * \brief Make a camera follow the entity, placing the entity at the center of camera.
+ * \param camera The camera which should shoot the entity.
+ */
+inline void Entity::CameraFollow(SDL_Rect& camera)
+{
+	int index = store != NULL ? store->Find(handle) : -1;
+	if (index < 0)
+		return;
+	SDL_Point size = store->Size(index);
+	SDL_Rect range = store->ranges[index];
+	//Move the camera in X direction.
+	camera.x = store->x[index] + size.x / 2 - camera.w / 2;
+	if (camera.x < 0)
+		camera.x = 0;
+	else if (camera.x + camera.w > range.x + range.w)
+		camera.x = range.x + range.w - camera.w;
+	//Move the camera in Y direction.
+	camera.y = store->y[index] + size.y / 2 - camera.h / 2;
+	if (camera.y < 0)
+		camera.y = 0;
+	else if (camera.y + camera.h > range.y + range.h)
+		camera.y = range.y + range.h - camera.h;
+}
+
+/*
+ * \brief Destroy the entity in its store.
+ */
+inline void Entity::Destroy()
+{
+	if (store != NULL)
+		store->Destroy(handle);
+}
+
+
+#endif // !entity_h_
\ No newline at end of file
@@ -10,7 +10,7 @@
  * \brief Show the last error message on the console.
  * \param message A string of message which shows the error.
  */
-void SDL_ReportError(std::string message)
+inline void SDL_ReportError(std::string message)
 {
 	std::string error = SDL_GetError();
 	printf("%s error: %s\n", message.c_str(), error.c_str());
@@ -20,7 +20,7 @@ void SDL_ReportError(std::string message)
  * \brief Show the last error message on the console.
  * \param message A string of message which shows the error.
  */
-void TTF_ReportError(std::string message)
+inline void TTF_ReportError(std::string message)
 {
 	std::string error = TTF_GetError();
 	printf("%s error: %s\n", message.c_str(), error.c_str());
@@ -30,7 +30,7 @@ void TTF_ReportError(std::string message)
  * \brief Show the last error message on the console.
  * \param message A string of message which shows the error.
  */
-void Mix_ReportError(std::string message)
+inline void Mix_ReportError(std::string message)
 {
 	std::string error = Mix_GetError();
 	printf("%s error: %s\n", message.c_str(), error.c_str());
@@ -0,0 +1,364 @@
+#ifndef eventhub_h_
+#define eventhub_h_
+
+#include <functional>
+#include <vector>
+#include <SDL.h>
+#include <profiler.h>
+#include <error.h>
+
+//A function called with the events it was registered for.
+struct EventHandler
+{
+	int id;
+	std::function<void(const SDL_Event&)> function;
+	//Cleared by Unsubscribe(), which leaves the function alive until no dispatch can be running it.
+	bool alive;
+};
+
+//Event hub wrapper class
+class EventHub
+{
+private:
+	//The events taken from the queue in the current pump, which keeps its capacity.
+	std::vector<SDL_Event> events;
+	//Handlers in flat tables, indexed by event type and by window ID.
+	std::vector<std::vector<EventHandler>> types;
+	std::vector<std::vector<EventHandler>> windows;
+	//Handlers registered while dispatching, which join the tables afterwards.
+	std::vector<std::pair<Uint32, EventHandler>> PendingTypes, PendingWindows;
+	bool dispatching;
+	bool removed;
+	int NextID;
+	bool quit;
+	Uint64 coalesced, dispatched;
+	void Add(std::vector<std::vector<EventHandler>>& table, Uint32 key, EventHandler handler);
+	void Coalesce(const SDL_Event& event);
+	void Call(std::vector<std::vector<EventHandler>>& table, Uint32 key, const SDL_Event& event);
+	void Sweep(std::vector<std::vector<EventHandler>>& table);
+public:
+	EventHub();
+	~EventHub();
+	int Subscribe(Uint32 type, std::function<void(const SDL_Event&)> function);
+	int SubscribeWindow(Uint32 WindowID, std::function<void(const SDL_Event&)> function);
+	void Unsubscribe(int id);
+	int Pump();
+	void Dispatch(const SDL_Event& event);
+	bool QuitRequested();
+	Uint64 GetCoalesced();
+	Uint64 GetDispatched();
+	void free();
+};
+
+/*
+ * \brief Get the window which an event happened in.
+ * \param event The event.
+ * \return The ID of the window, or 0 if the event doesn't belong to a window.
+ */
+inline Uint32 EventWindowID(const SDL_Event& event)
+{
+	switch (event.type)
+	{
+		case SDL_WINDOWEVENT:
+			return event.window.windowID;
+		case SDL_KEYDOWN:
+		case SDL_KEYUP:
+			return event.key.windowID;
+		case SDL_TEXTEDITING:
+			return event.edit.windowID;
+		case SDL_TEXTINPUT:
+			return event.text.windowID;
+		case SDL_MOUSEMOTION:
+			return event.motion.windowID;
+		case SDL_MOUSEBUTTONDOWN:
+		case SDL_MOUSEBUTTONUP:
+			return event.button.windowID;
+		case SDL_MOUSEWHEEL:
+			return event.wheel.windowID;
+		case SDL_DROPFILE:
+		case SDL_DROPTEXT:
+		case SDL_DROPBEGIN:
+		case SDL_DROPCOMPLETE:
+			return event.drop.windowID;
+	}
+	if (event.type >= SDL_USEREVENT && event.type < SDL_LASTEVENT)
+		return event.user.windowID;
+	return 0;
+}
+
+/*
+ * \brief Create an event hub without handlers.
+ */
+inline EventHub::EventHub()
+{
+	dispatching = false;
+	removed = false;
+	NextID = 0;
+	quit = false;
+	coalesced = 0;
+	dispatched = 0;
+}
+
+/*
+ * \brief Deallocate the event hub.
+ */
+inline EventHub::~EventHub()
+{
+	free();
+}
+
+/*
+ * \brief Add a handler into a table, growing the table to the key.
+ */
+inline void EventHub::Add(std::vector<std::vector<EventHandler>>& table, Uint32 key, EventHandler handler)
+{
+	if (key >= table.size())
+		table.resize(key + 1);
+	table[key].push_back(std::move(handler));
+}
+
+/*
+ * \brief Register a handler for a type of events.
+ * \param type The type of events, such as SDL_KEYDOWN.
+ * \param function The function called with every event of the type.
+ * \return The ID of the handler, for Unsubscribe().
+ */
+inline int EventHub::Subscribe(Uint32 type, std::function<void(const SDL_Event&)> function)
+{
+	EventHandler handler = { NextID++,std::move(function),true };
+	int id = handler.id;
+	if (dispatching)
+		PendingTypes.push_back({ type,std::move(handler) });
+	else
+		Add(types, type, std::move(handler));
+	return id;
+}
+
+/*
+ * \brief Register a handler for the events of a window, such as window, keyboard, text and mouse events.
+ * \param WindowID The ID of the window.
+ * \param function The function called with every event of the window.
+ * \return The ID of the handler, for Unsubscribe().
+ */
+inline int EventHub::SubscribeWindow(Uint32 WindowID, std::function<void(const SDL_Event&)> function)
+{
+	EventHandler handler = { NextID++,std::move(function),true };
+	int id = handler.id;
+	if (dispatching)
+		PendingWindows.push_back({ WindowID,std::move(handler) });
+	else
+		Add(windows, WindowID, std::move(handler));
+	return id;
+}
+
+/*
+ * \brief Remove a handler. It is safe to call from a handler.
+ * \param id The ID of the handler.
+ */
+inline void EventHub::Unsubscribe(int id)
+{
+	//Handlers are only flagged here, and destroyed when no dispatch walks them, since one may be removing itself.
+	std::vector<std::vector<EventHandler>>* tables[2] = { &types,&windows };
+	for (int t = 0; t < 2; t++)
+		for (int i = 0; i < tables[t]->size(); i++)
+			for (int j = 0; j < (*tables[t])[i].size(); j++)
+				if ((*tables[t])[i][j].id == id)
+					(*tables[t])[i][j].alive = false;
+	for (int i = 0; i < PendingTypes.size(); i++)
+		if (PendingTypes[i].second.id == id)
+			PendingTypes[i].second.alive = false;
+	for (int i = 0; i < PendingWindows.size(); i++)
+		if (PendingWindows[i].second.id == id)
+			PendingWindows[i].second.alive = false;
+	removed = true;
+	if (!dispatching)
+	{
+		Sweep(types);
+		Sweep(windows);
+		removed = false;
+	}
+}
+
+/*
+ * \brief Remove the flagged handlers from a table.
+ */
+inline void EventHub::Sweep(std::vector<std::vector<EventHandler>>& table)
+{
+	for (int i = 0; i < table.size(); i++)
+	{
+		int kept = 0;
+		for (int j = 0; j < table[i].size(); j++)
+			if (table[i][j].alive)
+			{
+				if (kept != j)
+					table[i][kept] = std::move(table[i][j]);
+				kept++;
+			}
+		table[i].resize(kept);
+	}
+}
+
+/*
+ * \brief Keep an event taken from the queue, merging it into an earlier one which it makes redundant.
+ * Consecutive mouse motions in a window become one motion with the summed relative motion,
+ * and a resize of a window replaces the earlier resize of the same kind.
+ */
+inline void EventHub::Coalesce(const SDL_Event& event)
+{
+	if (event.type == SDL_MOUSEMOTION && !events.empty())
+	{
+		SDL_Event& last = events.back();
+		if (last.type == SDL_MOUSEMOTION && last.motion.windowID == event.motion.windowID && last.motion.which == event.motion.which && last.motion.state == event.motion.state)
+		{
+			int xrel = last.motion.xrel + event.motion.xrel;
+			int yrel = last.motion.yrel + event.motion.yrel;
+			last = event;
+			last.motion.xrel = xrel;
+			last.motion.yrel = yrel;
+			coalesced++;
+			return;
+		}
+	}
+	else if (event.type == SDL_WINDOWEVENT && (event.window.event == SDL_WINDOWEVENT_RESIZED || event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED))
+	{
+		for (int i = (int)events.size() - 1; i >= 0; i--)
+		{
+			if (events[i].type == SDL_WINDOWEVENT && events[i].window.windowID == event.window.windowID && events[i].window.event == event.window.event)
+			{
+				//Dropped events are skipped when dispatching.
+				events[i].type = SDL_FIRSTEVENT;
+				coalesced++;
+				break;
+			}
+		}
+	}
+	events.push_back(event);
+}
+
+/*
+ * \brief Take all events from the queue in bulk, merge redundant ones and dispatch the rest.
+ * \return The number of events dispatched.
+ */
+inline int EventHub::Pump()
+{
+	PROFILE_ZONE("EventHub::Pump");
+	events.clear();
+	SDL_PumpEvents();
+	SDL_Event buffer[64];
+	while (1)
+	{
+		int count = SDL_PeepEvents(buffer, 64, SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+		if (count < 0)
+		{
+			SDL_ReportError("SDL_PeepEvents");
+			break;
+		}
+		for (int i = 0; i < count; i++)
+			Coalesce(buffer[i]);
+		if (count < 64)
+			break;
+	}
+	int count = 0;
+	for (int i = 0; i < events.size(); i++)
+	{
+		if (events[i].type == SDL_FIRSTEVENT)
+			continue;
+		Dispatch(events[i]);
+		count++;
+	}
+	return count;
+}
+
+/*
+ * \brief Call the handlers in a table for an event.
+ */
+inline void EventHub::Call(std::vector<std::vector<EventHandler>>& table, Uint32 key, const SDL_Event& event)
+{
+	if (key >= table.size())
+		return;
+	//Walk by index, since handlers registered meanwhile wait in the pending list and the table never grows here.
+	std::vector<EventHandler>& handlers = table[key];
+	for (int i = 0; i < handlers.size(); i++)
+		if (handlers[i].alive && handlers[i].function)
+			handlers[i].function(event);
+}
+
+/*
+ * \brief Send an event to the handlers of its window, then to the handlers of its type.
+ * \param event The event, which may also come from elsewhere than the queue.
+ */
+inline void EventHub::Dispatch(const SDL_Event& event)
+{
+	if (event.type == SDL_QUIT)
+		quit = true;
+	bool outer = !dispatching;
+	dispatching = true;
+	Uint32 WindowID = EventWindowID(event);
+	if (WindowID != 0)
+		Call(windows, WindowID, event);
+	Call(types, event.type, event);
+	dispatched++;
+	if (!outer)
+		return;
+	dispatching = false;
+	for (int i = 0; i < PendingTypes.size(); i++)
+		if (PendingTypes[i].second.alive)
+			Add(types, PendingTypes[i].first, std::move(PendingTypes[i].second));
+	for (int i = 0; i < PendingWindows.size(); i++)
+		if (PendingWindows[i].second.alive)
+			Add(windows, PendingWindows[i].first, std::move(PendingWindows[i].second));
+	PendingTypes.clear();
+	PendingWindows.clear();
+	if (removed)
+	{
+		Sweep(types);
+		Sweep(windows);
+		removed = false;
+	}
+}
+
+/*
+ * \brief Determine if a quit event has been dispatched.
+ * \return 1 if quit is requested, or 0 if not.
+ */
+inline bool EventHub::QuitRequested()
+{
+	return quit;
+}
+
+/*
+ * \brief Get the number of events merged into others since the hub was created.
+ * \return The number of events.
+ */
+inline Uint64 EventHub::GetCoalesced()
+{
+	return coalesced;
+}
+
+/*
+ * \brief Get the number of events dispatched since the hub was created.
+ * \return The number of events.
+ */
+inline Uint64 EventHub::GetDispatched()
+{
+	return dispatched;
+}
+
+/*
+ * \brief Remove all handlers and reset the counters.
+ */
+inline void EventHub::free()
+{
+	std::vector<SDL_Event>().swap(events);
+	types.clear();
+	windows.clear();
+	PendingTypes.clear();
+	PendingWindows.clear();
+	removed = false;
+	quit = false;
+	coalesced = 0;
+	dispatched = 0;
+}
+
+
+#endif // !eventhub_h_
\ No newline at end of file
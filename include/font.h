@@ -0,0 +1,361 @@
+#ifndef font_h_
+#define font_h_
+
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <unordered_map>
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <atlas.h>
+#include <spritebatch.h>
+#include <error.h>
+
+/*
+ * \brief Decode a character of a UTF-8 string.
+ * \param text The UTF-8 string.
+ * \param length The length of the string in bytes.
+ * \param i The position of the character, which is moved to the next character.
+ * \return The code point of the character, or 0xFFFD if the bytes are invalid.
+ */
+inline Uint32 DecodeUTF8(const char* text, int length, int& i)
+{
+	Uint8 c = (Uint8)text[i++];
+	if (c < 0x80)
+		return c;
+	//Get the number of following bytes from the first one.
+	int follow = 0;
+	Uint32 code = 0;
+	if ((c & 0xE0) == 0xC0)
+	{
+		follow = 1;
+		code = c & 0x1F;
+	}
+	else if ((c & 0xF0) == 0xE0)
+	{
+		follow = 2;
+		code = c & 0x0F;
+	}
+	else if ((c & 0xF8) == 0xF0)
+	{
+		follow = 3;
+		code = c & 0x07;
+	}
+	else
+		return 0xFFFD;
+	for (int j = 0; j < follow; j++)
+	{
+		if (i >= length || ((Uint8)text[i] & 0xC0) != 0x80)
+			return 0xFFFD;
+		code = (code << 6) | ((Uint8)text[i++] & 0x3F);
+	}
+	return code;
+}
+
+//Font pool wrapper class
+class FontPool
+{
+private:
+	//Opened fonts keyed by (path, size).
+	std::map<std::pair<std::string, int>, TTF_Font*> fonts;
+public:
+	FontPool();
+	~FontPool();
+	TTF_Font* Get(const char* file, int size);
+	int Size();
+	void free();
+};
+
+/*
+ * \brief Create an empty font pool.
+ */
+inline FontPool::FontPool()
+{
+}
+
+/*
+ * \brief Deallocate the font pool.
+ */
+inline FontPool::~FontPool()
+{
+	//Fonts can't be closed any more once SDL_ttf has quit.
+	if (TTF_WasInit())
+		free();
+}
+
+/*
+ * \brief Get a font, which is opened on the first request and kept open afterwards.
+ * \param file The path of the font.
+ * \param size The size of text.
+ * \return The font owned by the pool, or NULL if failed.
+ */
+inline TTF_Font* FontPool::Get(const char* file, int size)
+{
+	std::pair<std::string, int> key(file, size);
+	auto found = fonts.find(key);
+	if (found != fonts.end())
+		return found->second;
+	TTF_Font* font = TTF_OpenFont(file, size);
+	if (font == NULL)
+	{
+		TTF_ReportError("TTF_OpenFont");
+		return NULL;
+	}
+	fonts[key] = font;
+	return font;
+}
+
+/*
+ * \brief Get the number of opened fonts.
+ * \return The number of opened fonts.
+ */
+inline int FontPool::Size()
+{
+	return (int)fonts.size();
+}
+
+/*
+ * \brief Close all fonts. Call it before TTF_Quit().
+ */
+inline void FontPool::free()
+{
+	for (auto& font : fonts)
+		TTF_CloseFont(font.second);
+	fonts.clear();
+}
+
+/*
+ * \brief Get the font pool shared by all textures.
+ * \return The shared font pool.
+ */
+inline FontPool& GetFontPool()
+{
+	static FontPool pool;
+	return pool;
+}
+
+//Glyph cache wrapper class
+class GlyphCache
+{
+private:
+	struct Glyph
+	{
+		//The number of the glyph in the atlas, or -1 for glyphs with no pixels.
+		int id;
+		int w, h;
+		int advance;
+	};
+	TTF_Font* font;
+	Atlas atlas;
+	Glyph ascii[128];
+	std::unordered_map<Uint32, Glyph> glyphs;
+	int lineskip;
+	Glyph Rasterize(Uint32 code);
+	const Glyph& Find(Uint32 code);
+public:
+	GlyphCache();
+	~GlyphCache();
+	bool Init(SDL_Renderer* renderer, const char* file, int size);
+	void Draw(SpriteBatch& batch, std::string_view message, SDL_Point point, SDL_Color color);
+	SDL_Point Measure(std::string_view message);
+	int Advance(Uint32 code, Uint32 previous);
+	Atlas& GetAtlas();
+	int GetLineSkip();
+	void free();
+};
+
+/*
+ * \brief Create an empty glyph cache.
+ */
+inline GlyphCache::GlyphCache()
+{
+	font = NULL;
+	lineskip = 0;
+	for (int i = 0; i < 128; i++)
+		ascii[i] = { -2,0,0,0 };
+}
+
+/*
+ * \brief Deallocate the glyph cache.
+ */
+inline GlyphCache::~GlyphCache()
+{
+	free();
+}
+
+/*
+ * \brief Prepare a glyph cache for a font.
+ * \param renderer The renderer which should draw the text.
+ * \param file The path of the font, which is opened through the shared font pool.
+ * \param size The size of text.
+ * \return 1 if succeeded, or 0 if failed.
+ */
+inline bool GlyphCache::Init(SDL_Renderer* renderer, const char* file, int size)
+{
+	free();
+	font = GetFontPool().Get(file, size);
+	if (font == NULL)
+		return 0;
+	lineskip = TTF_FontLineSkip(font);
+	//Glyphs are packed as they are first used, so build the empty atlas right away.
+	atlas.Init(renderer, 512);
+	atlas.Build();
+	return 1;
+}
+
+/*
+ * \brief Rasterize a glyph in white and pack it into the atlas.
+ */
+inline GlyphCache::Glyph GlyphCache::Rasterize(Uint32 code)
+{
+	Glyph glyph = { -1,0,0,0 };
+	int minx, maxx, miny, maxy;
+	if (TTF_GlyphMetrics32(font, code, &minx, &maxx, &miny, &maxy, &glyph.advance) != 0)
+		return glyph;
+	SDL_Surface* surface = TTF_RenderGlyph32_Blended(font, code, { 255,255,255,255 });
+	if (surface == NULL)
+		return glyph;
+	glyph.w = surface->w;
+	glyph.h = surface->h;
+	glyph.id = atlas.Add(surface);
+	SDL_FreeSurface(surface);
+	return glyph;
+}
+
+/*
+ * \brief Get a glyph, rasterizing it on the first use.
+ */
+inline const GlyphCache::Glyph& GlyphCache::Find(Uint32 code)
+{
+	if (code < 128)
+	{
+		if (ascii[code].id == -2)
+			ascii[code] = Rasterize(code);
+		return ascii[code];
+	}
+	auto found = glyphs.find(code);
+	if (found != glyphs.end())
+		return found->second;
+	return glyphs[code] = Rasterize(code);
+}
+
+/*
+ * \brief Draw a line of text through a sprite batch, which must have been started with GetAtlas().
+ * \param batch The sprite batch collecting the glyphs.
+ * \param message The UTF-8 string of message, in which '\n' starts a new line.
+ * \param point The destination coordinate of the top left corner.
+ * \param color The color of text.
+ */
+inline void GlyphCache::Draw(SpriteBatch& batch, std::string_view message, SDL_Point point, SDL_Color color)
+{
+	if (font == NULL)
+		return;
+	//Keep the tint of the caller for the sprites drawn after the text.
+	SDL_Color tint = batch.GetColor();
+	batch.SetColor(color.r, color.g, color.b);
+	batch.SetAlpha(color.a);
+	int x = point.x, y = point.y;
+	Uint32 previous = 0;
+	for (int i = 0; i < message.size();)
+	{
+		Uint32 code = DecodeUTF8(message.data(), (int)message.size(), i);
+		if (code == '\n')
+		{
+			x = point.x;
+			y += lineskip;
+			previous = 0;
+			continue;
+		}
+		if (previous != 0)
+			x += TTF_GetFontKerningSizeGlyphs32(font, previous, code);
+		const Glyph& glyph = Find(code);
+		if (glyph.id >= 0)
+			batch.Clear(glyph.id, { x,y });
+		x += glyph.advance;
+		previous = code;
+	}
+	batch.SetColor(tint.r, tint.g, tint.b);
+	batch.SetAlpha(tint.a);
+}
+
+/*
+ * \brief Measure the size of text without drawing it.
+ * \param message The UTF-8 string of message, in which '\n' starts a new line.
+ * \return The width (x) and height (y) of text.
+ */
+inline SDL_Point GlyphCache::Measure(std::string_view message)
+{
+	SDL_Point size = { 0,0 };
+	if (font == NULL)
+		return size;
+	int x = 0;
+	size.y = lineskip;
+	Uint32 previous = 0;
+	for (int i = 0; i < message.size();)
+	{
+		Uint32 code = DecodeUTF8(message.data(), (int)message.size(), i);
+		if (code == '\n')
+		{
+			x = 0;
+			size.y += lineskip;
+			previous = 0;
+			continue;
+		}
+		if (previous != 0)
+			x += TTF_GetFontKerningSizeGlyphs32(font, previous, code);
+		x += Find(code).advance;
+		if (x > size.x)
+			size.x = x;
+		previous = code;
+	}
+	return size;
+}
+
+/*
+ * \brief Get how far a character moves the pen, such as for wrapping text.
+ * \param code The code point of the character.
+ * \param previous The code point of the character before, or 0 for none.
+ * \return The advance including the kerning with the previous character, in pixels.
+ */
+inline int GlyphCache::Advance(Uint32 code, Uint32 previous)
+{
+	if (font == NULL)
+		return 0;
+	int kerning = previous != 0 ? TTF_GetFontKerningSizeGlyphs32(font, previous, code) : 0;
+	return kerning + Find(code).advance;
+}
+
+/*
+ * \brief Get the atlas holding the glyphs, which a sprite batch should be started with.
+ * \return The atlas of glyphs.
+ */
+inline Atlas& GlyphCache::GetAtlas()
+{
+	return atlas;
+}
+
+/*
+ * \brief Get the distance between two lines of text.
+ * \return The distance in pixels.
+ */
+inline int GlyphCache::GetLineSkip()
+{
+	return lineskip;
+}
+
+/*
+ * \brief Deallocate the glyph cache. The font stays open in the font pool.
+ */
+inline void GlyphCache::free()
+{
+	atlas.free();
+	glyphs.clear();
+	for (int i = 0; i < 128; i++)
+		ascii[i] = { -2,0,0,0 };
+	font = NULL;
+	lineskip = 0;
+}
+
+
+#endif // !font_h_
\ No newline at end of file
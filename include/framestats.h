@@ -0,0 +1,278 @@
+#ifndef framestats_h_
+#define framestats_h_
+
+#include <math.h>
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+#include <SDL.h>
+#include <error.h>
+
+//Frame statistics wrapper class
+class FrameStats
+{
+private:
+	//Durations of the latest frames in milliseconds, as a ring buffer.
+	std::vector<double> frames;
+	//Scratch space for percentiles, allocated with the ring buffer.
+	std::vector<double> sorted;
+	//Histogram of the frames in the ring buffer, with the last bucket holding all longer frames.
+	std::vector<int> buckets;
+	double width;
+	int next, count;
+	double budget;
+	int Bucket(double ms);
+	bool Open(const char* file, FILE*& stream);
+public:
+	FrameStats();
+	~FrameStats();
+	void Init(int capacity = 1024, double budget = 1000.0 / 60, double width = 0.5, int buckets = 100);
+	void SetBudget(double budget);
+	void Record(double ms);
+	int Size();
+	double Mean();
+	double Min();
+	double Max();
+	double Percentile(double p);
+	int OverBudget();
+	bool WriteCSV(const char* file);
+	bool WriteJSON(const char* file);
+	void Clear();
+	void free();
+};
+
+/*
+ * \brief Create empty statistics.
+ */
+inline FrameStats::FrameStats()
+{
+	width = 0.5;
+	next = 0;
+	count = 0;
+	budget = 1000.0 / 60;
+}
+
+/*
+ * \brief Deallocate the statistics.
+ */
+inline FrameStats::~FrameStats()
+{
+	free();
+}
+
+/*
+ * \brief Allocate the statistics once, so that recording never allocates.
+ * \param capacity The number of latest frames kept.
+ * \param budget The longest acceptable frame in milliseconds.
+ * \param width The width of a histogram bucket in milliseconds.
+ * \param buckets The number of histogram buckets.
+ */
+inline void FrameStats::Init(int capacity, double budget, double width, int buckets)
+{
+	free();
+	if (capacity < 1)
+		capacity = 1;
+	if (buckets < 1)
+		buckets = 1;
+	frames.assign(capacity, 0);
+	sorted.assign(capacity, 0);
+	this->buckets.assign(buckets, 0);
+	this->width = width > 0 ? width : 0.5;
+	this->budget = budget;
+}
+
+/*
+ * \brief Set the longest acceptable frame.
+ * \param budget The number of milliseconds, such as 1000 divided by the target FPS.
+ */
+inline void FrameStats::SetBudget(double budget)
+{
+	this->budget = budget;
+}
+
+/*
+ * \brief Get the histogram bucket of a duration.
+ */
+inline int FrameStats::Bucket(double ms)
+{
+	int bucket = (int)(ms / width);
+	if (bucket < 0)
+		return 0;
+	return bucket < buckets.size() ? bucket : (int)buckets.size() - 1;
+}
+
+/*
+ * \brief Record the duration of a frame, replacing the oldest one when full.
+ * \param ms The number of milliseconds.
+ */
+inline void FrameStats::Record(double ms)
+{
+	if (frames.empty())
+		Init();
+	if (count == frames.size())
+		buckets[Bucket(frames[next])]--;
+	else
+		count++;
+	frames[next] = ms;
+	buckets[Bucket(ms)]++;
+	next = (next + 1) % frames.size();
+}
+
+/*
+ * \brief Get the number of recorded frames, which is at most the capacity.
+ * \return The number of frames.
+ */
+inline int FrameStats::Size()
+{
+	return count;
+}
+
+/*
+ * \brief Get the mean duration of recorded frames.
+ * \return The number of milliseconds, or 0 if none is recorded.
+ */
+inline double FrameStats::Mean()
+{
+	if (count == 0)
+		return 0;
+	double sum = 0;
+	for (int i = 0; i < count; i++)
+		sum += frames[i];
+	return sum / count;
+}
+
+/*
+ * \brief Get the shortest recorded frame.
+ * \return The number of milliseconds, or 0 if none is recorded.
+ */
+inline double FrameStats::Min()
+{
+	if (count == 0)
+		return 0;
+	return *std::min_element(frames.begin(), frames.begin() + count);
+}
+
+/*
+ * \brief Get the longest recorded frame.
+ * \return The number of milliseconds, or 0 if none is recorded.
+ */
+inline double FrameStats::Max()
+{
+	if (count == 0)
+		return 0;
+	return *std::max_element(frames.begin(), frames.begin() + count);
+}
+
+/*
+ * \brief Get a percentile of recorded frames, such as 50, 95, 99 or 99.9.
+ * \param p The percentage of frames which are not longer than the result.
+ * \return The number of milliseconds, or 0 if none is recorded.
+ */
+inline double FrameStats::Percentile(double p)
+{
+	if (count == 0)
+		return 0;
+	//Use the nearest rank, which is always one of the recorded frames.
+	int rank = (int)ceil(p / 100 * count) - 1;
+	rank = rank < 0 ? 0 : (rank >= count ? count - 1 : rank);
+	std::copy(frames.begin(), frames.begin() + count, sorted.begin());
+	std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.begin() + count);
+	return sorted[rank];
+}
+
+/*
+ * \brief Get the number of recorded frames longer than the budget.
+ * \return The number of frames.
+ */
+inline int FrameStats::OverBudget()
+{
+	int over = 0;
+	for (int i = 0; i < count; i++)
+		if (frames[i] > budget)
+			over++;
+	return over;
+}
+
+/*
+ * \brief Open a file for writing.
+ */
+inline bool FrameStats::Open(const char* file, FILE*& stream)
+{
+	stream = fopen(file, "w");
+	if (stream == NULL)
+	{
+		SDL_SetError("Couldn't open %s", file);
+		SDL_ReportError("FrameStats");
+		return 0;
+	}
+	return 1;
+}
+
+/*
+ * \brief Write the histogram into a CSV file, one bucket a row.
+ * \param file The path of the CSV file.
+ * \return 1 if succeeded, or 0 if failed.
+ */
+inline bool FrameStats::WriteCSV(const char* file)
+{
+	FILE* stream;
+	if (!Open(file, stream))
+		return 0;
+	fprintf(stream, "from_ms,to_ms,frames\n");
+	for (int i = 0; i < buckets.size(); i++)
+	{
+		if (i + 1 < buckets.size())
+			fprintf(stream, "%g,%g,%d\n", i * width, (i + 1) * width, buckets[i]);
+		else
+			fprintf(stream, "%g,,%d\n", i * width, buckets[i]);
+	}
+	fclose(stream);
+	return 1;
+}
+
+/*
+ * \brief Write the summary and the histogram into a JSON file.
+ * \param file The path of the JSON file.
+ * \return 1 if succeeded, or 0 if failed.
+ */
+inline bool FrameStats::WriteJSON(const char* file)
+{
+	FILE* stream;
+	if (!Open(file, stream))
+		return 0;
+	fprintf(stream, "{\n");
+	fprintf(stream, "  \"frames\": %d,\n  \"budget_ms\": %g,\n  \"over_budget\": %d,\n", count, budget, OverBudget());
+	fprintf(stream, "  \"mean_ms\": %g,\n  \"min_ms\": %g,\n  \"max_ms\": %g,\n", Mean(), Min(), Max());
+	fprintf(stream, "  \"p50_ms\": %g,\n  \"p95_ms\": %g,\n  \"p99_ms\": %g,\n  \"p99.9_ms\": %g,\n", Percentile(50), Percentile(95), Percentile(99), Percentile(99.9));
+	fprintf(stream, "  \"bucket_ms\": %g,\n  \"histogram\": [", width);
+	for (int i = 0; i < buckets.size(); i++)
+		fprintf(stream, i == 0 ? "%d" : ", %d", buckets[i]);
+	fprintf(stream, "]\n}\n");
+	fclose(stream);
+	return 1;
+}
+
+/*
+ * \brief Forget all recorded frames, keeping the allocation.
+ */
+inline void FrameStats::Clear()
+{
+	std::fill(buckets.begin(), buckets.end(), 0);
+	next = 0;
+	count = 0;
+}
+
+/*
+ * \brief Deallocate the statistics.
+ */
+inline void FrameStats::free()
+{
+	std::vector<double>().swap(frames);
+	std::vector<double>().swap(sorted);
+	std::vector<int>().swap(buckets);
+	next = 0;
+	count = 0;
+}
+
+
+#endif // !framestats_h_
\ No newline at end of file
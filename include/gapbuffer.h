@@ -0,0 +1,200 @@
+#ifndef gapbuffer_h_
+#define gapbuffer_h_
+
+#include <string.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//Gap buffer wrapper class
+class GapBuffer
+{
+private:
+	//The text is stored before and after a gap, which sits where the last edit was made.
+	std::vector<char> buffer;
+	int start, end;
+	void MoveGap(int position);
+	void Reserve(int length);
+public:
+	GapBuffer();
+	~GapBuffer();
+	void Insert(int position, const char* text, int length);
+	void Erase(int position, int length);
+	int Length();
+	char At(int position);
+	std::string_view View();
+	std::string Substring(int position, int length);
+	void Clear();
+	void free();
+};
+
+/*
+ * \brief Create an empty gap buffer.
+ */
+inline GapBuffer::GapBuffer()
+{
+	start = 0;
+	end = 0;
+}
+
+/*
+ * \brief Deallocate the gap buffer.
+ */
+inline GapBuffer::~GapBuffer()
+{
+	free();
+}
+
+/*
+ * \brief Move the gap to a position of the text, copying only the text between the old and new positions.
+ */
+inline void GapBuffer::MoveGap(int position)
+{
+	if (position < start)
+	{
+		int count = start - position;
+		memmove(buffer.data() + end - count, buffer.data() + position, count);
+		start -= count;
+		end -= count;
+	}
+	else if (position > start)
+	{
+		int count = position - start;
+		memmove(buffer.data() + start, buffer.data() + end, count);
+		start += count;
+		end += count;
+	}
+}
+
+/*
+ * \brief Make the gap hold at least a number of bytes, at least doubling the buffer when it grows.
+ */
+inline void GapBuffer::Reserve(int length)
+{
+	if (end - start >= length)
+		return;
+	int after = (int)buffer.size() - end;
+	int size = (int)buffer.size() * 2;
+	if (size < Length() + length + 64)
+		size = Length() + length + 64;
+	std::vector<char> grown(size);
+	if (start > 0)
+		memcpy(grown.data(), buffer.data(), start);
+	if (after > 0)
+		memcpy(grown.data() + size - after, buffer.data() + end, after);
+	buffer.swap(grown);
+	end = size - after;
+}
+
+/*
+ * \brief Insert text. Successive inserts at the same place take amortized constant time a byte.
+ * \param position The byte offset to insert at.
+ * \param text The inserted bytes.
+ * \param length The number of inserted bytes.
+ */
+inline void GapBuffer::Insert(int position, const char* text, int length)
+{
+	if (length <= 0)
+		return;
+	Reserve(length);
+	MoveGap(position < 0 ? 0 : (position > Length() ? Length() : position));
+	memcpy(buffer.data() + start, text, length);
+	start += length;
+}
+
+/*
+ * \brief Erase text. The erased bytes join the gap without being copied.
+ * \param position The byte offset of the first erased byte.
+ * \param length The number of erased bytes.
+ */
+inline void GapBuffer::Erase(int position, int length)
+{
+	if (position < 0)
+	{
+		length += position;
+		position = 0;
+	}
+	if (position + length > Length())
+		length = Length() - position;
+	if (length <= 0)
+		return;
+	MoveGap(position);
+	end += length;
+}
+
+/*
+ * \brief Get the length of the text.
+ * \return The number of bytes.
+ */
+inline int GapBuffer::Length()
+{
+	return (int)buffer.size() - (end - start);
+}
+
+/*
+ * \brief Get a byte of the text.
+ * \param position The byte offset, which must be less than the length.
+ * \return The byte.
+ */
+inline char GapBuffer::At(int position)
+{
+	return position < start ? buffer[position] : buffer[position + end - start];
+}
+
+/*
+ * \brief View the text without copying it. The gap is moved to the end, so the view stays valid until the next edit.
+ * \return The view of the text.
+ */
+inline std::string_view GapBuffer::View()
+{
+	MoveGap(Length());
+	return std::string_view(buffer.data(), start);
+}
+
+/*
+ * \brief Copy a part of the text.
+ * \param position The byte offset of the first byte.
+ * \param length The number of bytes.
+ * \return The copied text.
+ */
+inline std::string GapBuffer::Substring(int position, int length)
+{
+	std::string text;
+	int last = position + length < Length() ? position + length : Length();
+	if (position < 0)
+		position = 0;
+	if (last <= position)
+		return text;
+	text.reserve(last - position);
+	//Copy the parts before and after the gap.
+	if (position < start)
+		text.append(buffer.data() + position, (last < start ? last : start) - position);
+	if (last > start)
+	{
+		int from = position > start ? position : start;
+		text.append(buffer.data() + from + end - start, last - from);
+	}
+	return text;
+}
+
+/*
+ * \brief Erase all text, keeping the allocation.
+ */
+inline void GapBuffer::Clear()
+{
+	start = 0;
+	end = (int)buffer.size();
+}
+
+/*
+ * \brief Deallocate the gap buffer.
+ */
+inline void GapBuffer::free()
+{
+	std::vector<char>().swap(buffer);
+	start = 0;
+	end = 0;
+}
+
+
+#endif // !gapbuffer_h_
\ No newline at end of file
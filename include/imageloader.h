@@ -0,0 +1,357 @@
+#ifndef imageloader_h_
+#define imageloader_h_
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+#include <SDL.h>
+#include <SDL_image.h>
+#include <texture.h>
+#include <error.h>
+
+//The state of an image loaded in the background.
+struct ImageLoad
+{
+	enum { Queued, Decoded, Ready, Failed };
+	std::string file;
+	bool keyed;
+	SDL_Color color;
+	SDL_Surface* surface;
+	Texture texture;
+	Texture* placeholder;
+	std::atomic<int> status;
+};
+
+//Handle of an image loaded in the background
+class ImageHandle
+{
+private:
+	std::shared_ptr<ImageLoad> load;
+public:
+	ImageHandle();
+	ImageHandle(std::shared_ptr<ImageLoad> load);
+	bool IsReady();
+	bool IsFailed();
+	Texture& Get();
+};
+
+/*
+ * \brief Create an empty handle.
+ */
+inline ImageHandle::ImageHandle()
+{
+}
+
+/*
+ * \brief Create a handle of a load.
+ */
+inline ImageHandle::ImageHandle(std::shared_ptr<ImageLoad> load):load(load)
+{
+}
+
+/*
+ * \brief Determine if the texture has been uploaded.
+ * \return 1 if ready, or 0 if not.
+ */
+inline bool ImageHandle::IsReady()
+{
+	return load != NULL && load->status == ImageLoad::Ready;
+}
+
+/*
+ * \brief Determine if the image couldn't be loaded.
+ * \return 1 if failed, or 0 if not.
+ */
+inline bool ImageHandle::IsFailed()
+{
+	return load == NULL || load->status == ImageLoad::Failed;
+}
+
+/*
+ * \brief Get the texture, or the placeholder of the loader while the image is still loading.
+ * \return The texture to be shown.
+ */
+inline Texture& ImageHandle::Get()
+{
+	static Texture empty;
+	if (load == NULL)
+		return empty;
+	if (load->status != ImageLoad::Ready && load->placeholder != NULL)
+		return *load->placeholder;
+	return load->texture;
+}
+
+//Asynchronous image loader wrapper class
+class ImageLoader
+{
+private:
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable wake;
+	//Images waiting to be decoded, and decoded images waiting to be uploaded.
+	std::deque<std::shared_ptr<ImageLoad>> queued;
+	std::deque<std::shared_ptr<ImageLoad>> decoded;
+	bool quit;
+	Texture* placeholder;
+	//Statistics of decoding.
+	std::atomic<Uint64> images;
+	std::atomic<Uint64> bytes;
+	Uint64 first, last;
+	int pending;
+	void Work();
+	ImageHandle Queue(const char* file, bool keyed, SDL_Color color);
+public:
+	ImageLoader();
+	~ImageLoader();
+	bool Start(int threads = 0);
+	ImageHandle Load(const char* file);
+	ImageHandle Load(const char* file, SDL_Color color);
+	int Upload(SDL_Renderer* renderer, int limit);
+	void SetPlaceholder(Texture* placeholder);
+	int Pending();
+	double ImagesPerSecond();
+	double MegabytesPerSecond();
+	void Stop();
+	void free();
+};
+
+/*
+ * \brief Create a loader without worker threads.
+ */
+inline ImageLoader::ImageLoader()
+{
+	quit = false;
+	placeholder = NULL;
+	images = 0;
+	bytes = 0;
+	first = 0;
+	last = 0;
+	pending = 0;
+}
+
+/*
+ * \brief Deallocate the loader.
+ */
+inline ImageLoader::~ImageLoader()
+{
+	free();
+}
+
+/*
+ * \brief Start the worker threads which decode images.
+ * \param threads The number of worker threads, or 0 for one less than the number of CPU cores.
+ * \return 1 if succeeded, or 0 if the loader had been started.
+ */
+inline bool ImageLoader::Start(int threads)
+{
+	if (!workers.empty())
+		return 0;
+	if (threads <= 0)
+		threads = SDL_GetCPUCount() > 1 ? SDL_GetCPUCount() - 1 : 1;
+	quit = false;
+	for (int i = 0; i < threads; i++)
+		workers.push_back(std::thread(&ImageLoader::Work, this));
+	return 1;
+}
+
+/*
+ * \brief Decode queued images until the loader stops.
+ */
+inline void ImageLoader::Work()
+{
+	while (true)
+	{
+		std::shared_ptr<ImageLoad> load;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [this] { return quit || !queued.empty(); });
+			if (quit)
+				return;
+			load = queued.front();
+			queued.pop_front();
+		}
+		//Decode outside the lock, so that workers run in parallel.
+		SDL_Surface* surface = IMG_Load(load->file.c_str());
+		if (surface != NULL && load->keyed)
+			SDL_SetColorKey(surface, SDL_TRUE, SDL_MapRGB(surface->format, load->color.r, load->color.g, load->color.b));
+		std::lock_guard<std::mutex> lock(mutex);
+		if (surface == NULL)
+		{
+			SDL_ReportError("IMG_Load");
+			load->status = ImageLoad::Failed;
+			pending--;
+			continue;
+		}
+		load->surface = surface;
+		load->status = ImageLoad::Decoded;
+		decoded.push_back(load);
+		images++;
+		bytes += (Uint64)surface->pitch * surface->h;
+		last = SDL_GetPerformanceCounter();
+	}
+}
+
+/*
+ * \brief Queue an image for the worker threads.
+ */
+inline ImageHandle ImageLoader::Queue(const char* file, bool keyed, SDL_Color color)
+{
+	std::shared_ptr<ImageLoad> load = std::make_shared<ImageLoad>();
+	load->file = file;
+	load->keyed = keyed;
+	load->color = color;
+	load->surface = NULL;
+	load->placeholder = placeholder;
+	load->status = ImageLoad::Queued;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		//Start timing when the loader becomes busy.
+		if (pending == 0)
+		{
+			first = SDL_GetPerformanceCounter();
+			last = first;
+			images = 0;
+			bytes = 0;
+		}
+		queued.push_back(load);
+		pending++;
+	}
+	wake.notify_one();
+	return ImageHandle(load);
+}
+
+/*
+ * \brief Load an image in the background.
+ * \param file The path of the source image.
+ * \return A handle which gives the texture once it has been uploaded.
+ */
+inline ImageHandle ImageLoader::Load(const char* file)
+{
+	return Queue(file, false, { 0,0,0,0 });
+}
+
+/*
+ * \brief Load an image in the background, and make a color transparent.
+ * \param file The path of the source image.
+ * \param color The color to be made transparent.
+ * \return A handle which gives the texture once it has been uploaded.
+ */
+inline ImageHandle ImageLoader::Load(const char* file, SDL_Color color)
+{
+	return Queue(file, true, color);
+}
+
+/*
+ * \brief Upload decoded images into textures. Call it once a frame on the rendering thread.
+ * \param renderer The renderer which should copy parts of the textures.
+ * \param limit The largest number of images uploaded in this call, which bounds the time spent in a frame.
+ * \return The number of uploaded images.
+ */
+inline int ImageLoader::Upload(SDL_Renderer* renderer, int limit)
+{
+	int uploaded = 0;
+	while (uploaded < limit)
+	{
+		std::shared_ptr<ImageLoad> load;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (decoded.empty())
+				break;
+			load = decoded.front();
+			decoded.pop_front();
+			pending--;
+		}
+		load->texture.CreateFromSurface(renderer, load->surface);
+		SDL_FreeSurface(load->surface);
+		load->surface = NULL;
+		load->status = load->texture.GetWidth() > 0 ? ImageLoad::Ready : ImageLoad::Failed;
+		uploaded++;
+	}
+	return uploaded;
+}
+
+/*
+ * \brief Set the texture shown by handles of images which are still loading.
+ * \param placeholder The placeholder texture, which must outlive the handles, or NULL for none.
+ */
+inline void ImageLoader::SetPlaceholder(Texture* placeholder)
+{
+	this->placeholder = placeholder;
+}
+
+/*
+ * \brief Get the number of images which haven't been uploaded.
+ * \return The number of images still loading.
+ */
+inline int ImageLoader::Pending()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return pending;
+}
+
+/*
+ * \brief Get the decoding throughput since the loader last became busy.
+ * \return The number of images decoded per second.
+ */
+inline double ImageLoader::ImagesPerSecond()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (last <= first)
+		return 0;
+	return images / ((double)(last - first) / SDL_GetPerformanceFrequency());
+}
+
+/*
+ * \brief Get the decoding throughput since the loader last became busy.
+ * \return The number of megabytes of pixels decoded per second.
+ */
+inline double ImageLoader::MegabytesPerSecond()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (last <= first)
+		return 0;
+	return bytes / 1048576.0 / ((double)(last - first) / SDL_GetPerformanceFrequency());
+}
+
+/*
+ * \brief Stop the worker threads. Images being decoded are finished, and the rest stay queued.
+ */
+inline void ImageLoader::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quit = true;
+	}
+	wake.notify_all();
+	for (int i = 0; i < workers.size(); i++)
+		workers[i].join();
+	workers.clear();
+}
+
+/*
+ * \brief Stop the loader, and drop all images which haven't been uploaded.
+ */
+inline void ImageLoader::free()
+{
+	Stop();
+	for (int i = 0; i < queued.size(); i++)
+		queued[i]->status = ImageLoad::Failed;
+	for (int i = 0; i < decoded.size(); i++)
+	{
+		SDL_FreeSurface(decoded[i]->surface);
+		decoded[i]->surface = NULL;
+		decoded[i]->status = ImageLoad::Failed;
+	}
+	queued.clear();
+	decoded.clear();
+	pending = 0;
+	quit = false;
+}
+
+
+#endif // !imageloader_h_
\ No newline at end of file
@@ -0,0 +1,253 @@
+#ifndef jobs_h_
+#define jobs_h_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <SDL.h>
+
+//A span of indices waiting to be run, from the first to before the last.
+struct JobRange
+{
+	int first, last;
+};
+
+//Deque of a worker, popped at the back by the owner and stolen at the front by the others.
+struct JobQueue
+{
+	std::mutex mutex;
+	std::deque<JobRange> ranges;
+};
+
+//Job system wrapper class
+class JobSystem
+{
+private:
+	std::vector<std::thread> threads;
+	//The queue 0 belongs to the thread calling ParallelFor, which works along with the workers.
+	std::vector<std::unique_ptr<JobQueue>> queues;
+	std::mutex mutex;
+	std::condition_variable wake;
+	//A new generation starts with every ParallelFor, on which sleeping workers wake up.
+	Uint64 generation;
+	bool quit;
+	const std::function<void(int, int)>* task;
+	int grain;
+	//The number of indices not run yet in the current ParallelFor.
+	std::atomic<int> remaining;
+	std::atomic<Uint64> steals;
+	void Work(int index);
+	bool Take(int index, JobRange& range);
+	void Run(int index, JobRange range);
+public:
+	JobSystem();
+	~JobSystem();
+	void Init(int workers = -1);
+	void ParallelFor(int count, int grain, const std::function<void(int, int)>& task);
+	int GetThreads();
+	Uint64 GetSteals();
+	void free();
+};
+
+/*
+ * \brief Create a job system without workers, which runs everything on the calling thread.
+ */
+inline JobSystem::JobSystem():remaining(0), steals(0)
+{
+	generation = 0;
+	quit = 0;
+	task = NULL;
+	grain = 1;
+	queues.push_back(std::unique_ptr<JobQueue>(new JobQueue()));
+}
+
+/*
+ * \brief Stop the workers and deallocate the job system.
+ */
+inline JobSystem::~JobSystem()
+{
+	free();
+}
+
+/*
+ * \brief Start the worker threads.
+ * \param workers The number of threads besides the calling one, or -1 for one less than the number of CPU cores.
+ */
+inline void JobSystem::Init(int workers)
+{
+	free();
+	if (workers < 0)
+		workers = SDL_GetCPUCount() - 1;
+	quit = 0;
+	for (int i = 0; i < workers; i++)
+		queues.push_back(std::unique_ptr<JobQueue>(new JobQueue()));
+	for (int i = 1; i <= workers; i++)
+		threads.push_back(std::thread(&JobSystem::Work, this, i));
+}
+
+/*
+ * \brief Run the loop of a worker, which sleeps between calls of ParallelFor.
+ * \param index The number of the queue of the worker.
+ */
+inline void JobSystem::Work(int index)
+{
+	Uint64 seen = 0;
+	while (1)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [&] { return quit || generation != seen; });
+			if (quit)
+				return;
+			seen = generation;
+		}
+		JobRange range;
+		while (remaining.load(std::memory_order_acquire) > 0)
+		{
+			if (Take(index, range))
+				Run(index, range);
+			else
+				std::this_thread::yield();
+		}
+	}
+}
+
+/*
+ * \brief Take a range from the back of the own queue, or steal one from the front of another queue.
+ * Stolen ranges are the oldest and so the largest ones, which keeps steals few.
+ * \param index The number of the queue of the calling thread.
+ * \param range The range taken.
+ * \return 1 if a range was taken, or 0 if all queues are empty.
+ */
+inline bool JobSystem::Take(int index, JobRange& range)
+{
+	{
+		JobQueue& own = *queues[index];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (!own.ranges.empty())
+		{
+			range = own.ranges.back();
+			own.ranges.pop_back();
+			return 1;
+		}
+	}
+	for (int i = 1; i < queues.size(); i++)
+	{
+		JobQueue& victim = *queues[(index + i) % queues.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.ranges.empty())
+		{
+			range = victim.ranges.front();
+			victim.ranges.pop_front();
+			steals.fetch_add(1, std::memory_order_relaxed);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/*
+ * \brief Run a range, splitting off its upper halves into the own queue until it is no larger than the grain.
+ * \param index The number of the queue of the calling thread.
+ * \param range The range to be run.
+ */
+inline void JobSystem::Run(int index, JobRange range)
+{
+	JobQueue& own = *queues[index];
+	while (range.last - range.first > grain)
+	{
+		int middle = range.first + (range.last - range.first) / 2;
+		{
+			std::lock_guard<std::mutex> lock(own.mutex);
+			own.ranges.push_back({ middle,range.last });
+		}
+		range.last = middle;
+	}
+	(*task)(range.first, range.last);
+	remaining.fetch_sub(range.last - range.first, std::memory_order_acq_rel);
+}
+
+/*
+ * \brief Run a task over a span of indices on all threads, and wait until it is done.
+ * The task must not call SDL render functions, which only work on the thread owning the renderer.
+ * \param count The number of indices, from 0 to before count.
+ * \param grain The largest number of indices in a single call of the task.
+ * \param task The function called with the first index and the index after the last one of a part.
+ */
+inline void JobSystem::ParallelFor(int count, int grain, const std::function<void(int, int)>& task)
+{
+	if (count <= 0)
+		return;
+	if (grain < 1)
+		grain = 1;
+	//Small spans and a system without workers don't pay for waking threads.
+	if (threads.empty() || count <= grain)
+	{
+		task(0, count);
+		return;
+	}
+	this->task = &task;
+	this->grain = grain;
+	remaining.store(count, std::memory_order_release);
+	{
+		std::lock_guard<std::mutex> lock(queues[0]->mutex);
+		queues[0]->ranges.push_back({ 0,count });
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		generation++;
+	}
+	wake.notify_all();
+	JobRange range;
+	while (remaining.load(std::memory_order_acquire) > 0)
+	{
+		if (Take(0, range))
+			Run(0, range);
+		else
+			std::this_thread::yield();
+	}
+	this->task = NULL;
+}
+
+/*
+ * \brief Get the number of threads running tasks, including the calling one.
+ * \return The number of threads.
+ */
+inline int JobSystem::GetThreads()
+{
+	return (int)threads.size() + 1;
+}
+
+/*
+ * \brief Get the number of ranges which were stolen from another queue.
+ * \return The number of steals.
+ */
+inline Uint64 JobSystem::GetSteals()
+{
+	return steals.load(std::memory_order_relaxed);
+}
+
+/*
+ * \brief Stop the workers, leaving a job system which runs everything on the calling thread.
+ */
+inline void JobSystem::free()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quit = 1;
+	}
+	wake.notify_all();
+	for (int i = 0; i < threads.size(); i++)
+		threads[i].join();
+	threads.clear();
+	queues.resize(1);
+	steals.store(0, std::memory_order_relaxed);
+}
+
+
+#endif // !jobs_h_
\ No newline at end of file
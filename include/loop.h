@@ -0,0 +1,157 @@
+#ifndef loop_h_
+#define loop_h_
+
+#include <SDL.h>
+#include <timer.h>
+
+//Fixed timestep loop wrapper class
+class FixedLoop
+{
+private:
+	Timer clock;
+	//Times in nanoseconds.
+	Uint64 last;
+	Uint64 step;
+	Uint64 accumulator;
+	Uint64 MaxLag;
+	int MaxTicks;
+	int ticks;
+	Uint64 total;
+	Uint64 dropped;
+public:
+	FixedLoop();
+	~FixedLoop();
+	void Init(int rate = 60, int MaxTicks = 8, int MaxLag = 250);
+	void Begin();
+	bool Tick();
+	double Alpha();
+	double GetStep();
+	Uint64 GetTicks();
+	Uint64 GetDroppedTicks();
+	void free();
+};
+
+/*
+ * \brief Create a loop running 60 ticks a second.
+ */
+inline FixedLoop::FixedLoop():clock(1)
+{
+	last = 0;
+	step = 1000000000 / 60;
+	accumulator = 0;
+	MaxLag = 250000000;
+	MaxTicks = 8;
+	ticks = 0;
+	total = 0;
+	dropped = 0;
+}
+
+/*
+ * \brief Deallocate the loop.
+ */
+inline FixedLoop::~FixedLoop()
+{
+	free();
+}
+
+/*
+ * \brief Set the rate of the simulation, and start measuring time.
+ * \param rate The number of ticks a second, which doesn't depend on the FPS.
+ * \param MaxTicks The largest number of ticks in a frame, after which the frame is rendered and the rest are run in the following frames.
+ * \param MaxLag The largest number of milliseconds the simulation may fall behind. Longer hitches, such as dragging the window, are dropped.
+ */
+inline void FixedLoop::Init(int rate, int MaxTicks, int MaxLag)
+{
+	free();
+	step = 1000000000 / (rate > 0 ? rate : 60);
+	this->MaxTicks = MaxTicks > 0 ? MaxTicks : 1;
+	this->MaxLag = (Uint64)(MaxLag > 0 ? MaxLag : 250) * 1000000;
+	clock.Start();
+}
+
+/*
+ * \brief Start a frame, adding the time since the last frame to the simulation.
+ */
+inline void FixedLoop::Begin()
+{
+	if (!clock.IsStarted())
+		clock.Start();
+	Uint64 now = clock.GetTimeNS();
+	accumulator += now - last;
+	last = now;
+	//Drop the time which the simulation can't catch up with, instead of spiraling.
+	if (accumulator > MaxLag)
+	{
+		dropped += (accumulator - MaxLag) / step;
+		accumulator = MaxLag;
+	}
+	ticks = 0;
+}
+
+/*
+ * \brief Take a tick of the simulation if it is due. Run the simulation in "while (loop.Tick())".
+ * \return 1 if a tick should be run, or 0 if the frame should be rendered.
+ */
+inline bool FixedLoop::Tick()
+{
+	//Under load, more ticks are run in a frame, so render frames are dropped while the simulation keeps its speed.
+	if (accumulator < step || ticks >= MaxTicks)
+		return 0;
+	accumulator -= step;
+	ticks++;
+	total++;
+	return 1;
+}
+
+/*
+ * \brief Get how far the rendered frame is between the last two ticks, for MovableTexture::Show.
+ * \return A number from 0 to 1.
+ */
+inline double FixedLoop::Alpha()
+{
+	double alpha = (double)accumulator / step;
+	return alpha < 1 ? alpha : 1;
+}
+
+/*
+ * \brief Get the duration of a tick.
+ * \return The number of seconds, by which velocities should be scaled.
+ */
+inline double FixedLoop::GetStep()
+{
+	return step / 1000000000.0;
+}
+
+/*
+ * \brief Get the number of ticks run since Init().
+ * \return The number of ticks.
+ */
+inline Uint64 FixedLoop::GetTicks()
+{
+	return total;
+}
+
+/*
+ * \brief Get the number of ticks dropped by hitches longer than the largest lag.
+ * \return The number of ticks.
+ */
+inline Uint64 FixedLoop::GetDroppedTicks()
+{
+	return dropped;
+}
+
+/*
+ * \brief Stop the loop.
+ */
+inline void FixedLoop::free()
+{
+	clock.Reset();
+	last = 0;
+	accumulator = 0;
+	ticks = 0;
+	total = 0;
+	dropped = 0;
+}
+
+
+#endif // !loop_h_
\ No newline at end of file
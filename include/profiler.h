@@ -0,0 +1,370 @@
+#ifndef profiler_h_
+#define profiler_h_
+
+#include <stdio.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+#include <SDL.h>
+#include <error.h>
+
+//A zone measured on a thread, in values of the performance counter.
+struct ProfileEvent
+{
+	const char* name;
+	Uint64 start, end;
+};
+
+//The statistics of a zone in the last frame.
+struct ProfileStat
+{
+	const char* name;
+	int calls;
+	//Times in milliseconds.
+	double total;
+	double max;
+};
+
+//Event buffer of a thread, written by the thread and read by the profiler without locking.
+class ProfileBuffer
+{
+private:
+	std::vector<ProfileEvent> events;
+	//Positions only grow, and wrap around the buffer by the mask.
+	std::atomic<Uint32> head, tail;
+	Uint32 mask;
+	std::atomic<Uint64> dropped;
+public:
+	int tid;
+	ProfileBuffer(int tid, int capacity);
+	void Push(const ProfileEvent& event);
+	bool Pop(ProfileEvent& event);
+	Uint64 GetDropped();
+};
+
+/*
+ * \brief Create a buffer for a thread.
+ * \param tid The number of the thread shown in traces.
+ * \param capacity The number of events, which must be a power of 2.
+ */
+inline ProfileBuffer::ProfileBuffer(int tid, int capacity):events(capacity), head(0), tail(0), dropped(0)
+{
+	mask = capacity - 1;
+	this->tid = tid;
+}
+
+/*
+ * \brief Add an event on the owner thread. The event is dropped if the profiler hasn't read the buffer in time.
+ */
+inline void ProfileBuffer::Push(const ProfileEvent& event)
+{
+	Uint32 position = head.load(std::memory_order_relaxed);
+	if (position - tail.load(std::memory_order_acquire) > mask)
+	{
+		dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	events[position & mask] = event;
+	head.store(position + 1, std::memory_order_release);
+}
+
+/*
+ * \brief Take the oldest event on the profiler thread.
+ * \return 1 if an event was taken, or 0 if the buffer is empty.
+ */
+inline bool ProfileBuffer::Pop(ProfileEvent& event)
+{
+	Uint32 position = tail.load(std::memory_order_relaxed);
+	if (position == head.load(std::memory_order_acquire))
+		return 0;
+	event = events[position & mask];
+	tail.store(position + 1, std::memory_order_release);
+	return 1;
+}
+
+/*
+ * \brief Get the number of events dropped because the buffer was full.
+ * \return The number of events.
+ */
+inline Uint64 ProfileBuffer::GetDropped()
+{
+	return dropped.load(std::memory_order_relaxed);
+}
+
+//Profiler wrapper class
+class Profiler
+{
+private:
+	std::atomic<bool> enabled;
+	//Buffers are kept until the program ends, since threads hold pointers to them.
+	std::mutex mutex;
+	std::vector<std::unique_ptr<ProfileBuffer>> buffers;
+	//Statistics of every zone seen, so that aggregating frames doesn't allocate.
+	std::unordered_map<const char*, int> index;
+	std::vector<ProfileStat> frame;
+	Uint64 FrameStart;
+	bool capturing;
+	Uint64 origin;
+	std::vector<std::pair<int, ProfileEvent>> trace;
+	void Drain();
+public:
+	Profiler();
+	~Profiler();
+	void Enable(bool enabled);
+	bool IsEnabled();
+	ProfileBuffer& Local();
+	void BeginFrame();
+	void EndFrame();
+	const std::vector<ProfileStat>& GetFrame();
+	void StartCapture();
+	void StopCapture();
+	bool WriteTrace(const char* file);
+	Uint64 GetDropped();
+	void free();
+};
+
+/*
+ * \brief Create a disabled profiler.
+ */
+inline Profiler::Profiler():enabled(false)
+{
+	FrameStart = 0;
+	capturing = false;
+	origin = 0;
+}
+
+/*
+ * \brief Deallocate the profiler.
+ */
+inline Profiler::~Profiler()
+{
+	free();
+}
+
+/*
+ * \brief Turn zones on or off at runtime. Disabled zones only test this flag.
+ * \param enabled Whether zones are measured.
+ */
+inline void Profiler::Enable(bool enabled)
+{
+	this->enabled.store(enabled, std::memory_order_relaxed);
+}
+
+/*
+ * \brief Determine if zones are measured.
+ * \return 1 if enabled, or 0 if not.
+ */
+inline bool Profiler::IsEnabled()
+{
+	return enabled.load(std::memory_order_relaxed);
+}
+
+/*
+ * \brief Get the buffer of the calling thread, which is created on the first call.
+ * \return The buffer of the thread.
+ */
+inline ProfileBuffer& Profiler::Local()
+{
+	thread_local ProfileBuffer* buffer = NULL;
+	if (buffer == NULL)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		buffers.push_back(std::unique_ptr<ProfileBuffer>(new ProfileBuffer((int)buffers.size() + 1, 16384)));
+		buffer = buffers.back().get();
+	}
+	return *buffer;
+}
+
+/*
+ * \brief Inform the profiler that a new frame has started. FPSmonitor::StartOneFrame calls it.
+ */
+inline void Profiler::BeginFrame()
+{
+	if (IsEnabled())
+		FrameStart = SDL_GetPerformanceCounter();
+}
+
+/*
+ * \brief Read the events of all threads, and add them up into the statistics of the frame.
+ */
+inline void Profiler::Drain()
+{
+	double ms = 1000.0 / SDL_GetPerformanceFrequency();
+	for (int i = 0; i < frame.size(); i++)
+	{
+		frame[i].calls = 0;
+		frame[i].total = 0;
+		frame[i].max = 0;
+	}
+	std::lock_guard<std::mutex> lock(mutex);
+	ProfileEvent event;
+	for (int i = 0; i < buffers.size(); i++)
+		while (buffers[i]->Pop(event))
+		{
+			auto found = index.find(event.name);
+			if (found == index.end())
+			{
+				found = index.insert({ event.name,(int)frame.size() }).first;
+				frame.push_back({ event.name,0,0,0 });
+			}
+			ProfileStat& stat = frame[found->second];
+			double duration = (event.end - event.start) * ms;
+			stat.calls++;
+			stat.total += duration;
+			if (duration > stat.max)
+				stat.max = duration;
+			if (capturing)
+				trace.push_back({ buffers[i]->tid,event });
+		}
+}
+
+/*
+ * \brief Inform the profiler that a frame has ended. FPSmonitor::EndOneFrame calls it.
+ */
+inline void Profiler::EndFrame()
+{
+	if (!IsEnabled())
+		return;
+	if (capturing && FrameStart != 0)
+		Local().Push({ "Frame",FrameStart,SDL_GetPerformanceCounter() });
+	Drain();
+}
+
+/*
+ * \brief Get the statistics of zones in the last frame, including zones which weren't entered.
+ * \return A vector containing the statistics, in the order zones were first seen.
+ */
+inline const std::vector<ProfileStat>& Profiler::GetFrame()
+{
+	return frame;
+}
+
+/*
+ * \brief Start keeping every event for a trace, which grows until StopCapture().
+ */
+inline void Profiler::StartCapture()
+{
+	trace.clear();
+	origin = SDL_GetPerformanceCounter();
+	capturing = true;
+}
+
+/*
+ * \brief Stop keeping events for the trace.
+ */
+inline void Profiler::StopCapture()
+{
+	capturing = false;
+}
+
+/*
+ * \brief Write the captured events in the Chrome trace event format, which chrome://tracing and Perfetto can open.
+ * \param file The path of the JSON file.
+ * \return 1 if succeeded, or 0 if failed.
+ */
+inline bool Profiler::WriteTrace(const char* file)
+{
+	FILE* stream = fopen(file, "w");
+	if (stream == NULL)
+	{
+		SDL_SetError("Couldn't open %s", file);
+		SDL_ReportError("Profiler::WriteTrace");
+		return 0;
+	}
+	double us = 1000000.0 / SDL_GetPerformanceFrequency();
+	fprintf(stream, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	for (int i = 0; i < trace.size(); i++)
+	{
+		const ProfileEvent& event = trace[i].second;
+		double start = event.start > origin ? (event.start - origin) * us : 0;
+		fprintf(stream, "{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}%s\n",
+			event.name, start, (event.end - event.start) * us, trace[i].first, i + 1 < trace.size() ? "," : "");
+	}
+	fprintf(stream, "]}\n");
+	fclose(stream);
+	return 1;
+}
+
+/*
+ * \brief Get the number of events dropped by all threads.
+ * \return The number of events.
+ */
+inline Uint64 Profiler::GetDropped()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	Uint64 dropped = 0;
+	for (int i = 0; i < buffers.size(); i++)
+		dropped += buffers[i]->GetDropped();
+	return dropped;
+}
+
+/*
+ * \brief Forget all statistics and captured events. The buffers of threads are kept.
+ */
+inline void Profiler::free()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	ProfileEvent event;
+	for (int i = 0; i < buffers.size(); i++)
+		while (buffers[i]->Pop(event))
+			;
+	index.clear();
+	frame.clear();
+	std::vector<std::pair<int, ProfileEvent>>().swap(trace);
+	capturing = false;
+	FrameStart = 0;
+}
+
+/*
+ * \brief Get the profiler shared by all zones.
+ * \return The shared profiler.
+ */
+inline Profiler& GetProfiler()
+{
+	static Profiler profiler;
+	return profiler;
+}
+
+//Scoped profiling zone class, measuring from its construction to its destruction
+class ProfileZone
+{
+private:
+	const char* name;
+	Uint64 start;
+public:
+	ProfileZone(const char* name);
+	~ProfileZone();
+};
+
+/*
+ * \brief Enter a zone.
+ * \param name The name of the zone, which must be a string literal.
+ */
+inline ProfileZone::ProfileZone(const char* name)
+{
+	this->name = name;
+	start = GetProfiler().IsEnabled() ? SDL_GetPerformanceCounter() : 0;
+}
+
+/*
+ * \brief Leave a zone.
+ */
+inline ProfileZone::~ProfileZone()
+{
+	if (start != 0)
+		GetProfiler().Local().Push({ name,start,SDL_GetPerformanceCounter() });
+}
+
+//Define PROFILER_DISABLED to compile zones away.
+#ifdef PROFILER_DISABLED
+#define PROFILE_ZONE(name)
+#else
+#define PROFILE_ZONE_JOIN(a, b) a##b
+#define PROFILE_ZONE_LINE(line) PROFILE_ZONE_JOIN(profile_zone_, line)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_ZONE_LINE(__LINE__)(name)
+#endif
+
+
+#endif // !profiler_h_
\ No newline at end of file
@@ -0,0 +1,552 @@
+#ifndef renderqueue_h_
+#define renderqueue_h_
+
+#include <math.h>
+#include <unordered_map>
+#include <vector>
+#include <SDL.h>
+#include <profiler.h>
+#include <error.h>
+
+//A deferred copy of a texture, with the color, alpha and blend mode taken when it was queued.
+struct RenderCommand
+{
+	int id;
+	SDL_FPoint corners[4];
+	SDL_FPoint uv[2];
+	SDL_Color color;
+	SDL_BlendMode blend;
+};
+
+//Render queue wrapper class
+class RenderQueue
+{
+private:
+	SDL_Renderer* rend;
+	std::vector<RenderCommand> commands;
+	//Sort keys of the commands, and the scratch space of the radix sort.
+	std::vector<Uint64> keys, sorted;
+	//Textures used since the last flush, numbered in the order they were first queued.
+	std::vector<SDL_Texture*> textures;
+	std::unordered_map<SDL_Texture*, int> ids;
+	//The blend modes of the textures when flushing began, and the ones set meanwhile.
+	std::vector<SDL_BlendMode> original, blends;
+	//The quads of the run being merged.
+	std::vector<SDL_Vertex> vertices;
+	std::vector<int> indices;
+	//The sorted copies already drawn by an earlier run, and the bounds of the copies skipped while looking ahead.
+	std::vector<char> taken;
+	std::vector<SDL_FRect> skipped;
+	int layer, depth;
+	int calls, changes, saved;
+	void Add(SDL_Texture* texture, const SDL_Rect* clip, const SDL_FPoint corners[4], SDL_RendererFlip flip, SDL_Color color, SDL_BlendMode blend);
+	static void GetState(SDL_Texture* texture, SDL_Color& color, SDL_BlendMode& blend);
+	static SDL_FRect Bound(const RenderCommand& command);
+	static bool Overlap(const SDL_FRect& a, const SDL_FRect& b);
+	void Sort();
+	void Append(const RenderCommand& command);
+	void Submit(int id);
+public:
+	//Commands queued between flushes, limited by the bits of sort keys left for their order.
+	static const int MaxCommands = 1 << 24;
+	//Copies looked through after the start of a run for later copies which can join it.
+	static const int LookAhead = 64;
+	RenderQueue();
+	~RenderQueue();
+	void Begin(SDL_Renderer* renderer);
+	void SetLayer(int layer);
+	void SetDepth(int depth);
+	void Copy(SDL_Texture* texture, const SDL_Rect* clip, const SDL_Rect* viewport);
+	void CopyEx(SDL_Texture* texture, const SDL_Rect* clip, const SDL_Rect* viewport, double angle, const SDL_Point* center, SDL_RendererFlip flip);
+	void CopyEx(SDL_Texture* texture, const SDL_Rect* clip, const SDL_Rect* viewport, double angle, const SDL_Point* center, SDL_RendererFlip flip, SDL_Color color, SDL_BlendMode blend);
+	int Size();
+	void Flush();
+	int End();
+	int GetDrawCalls();
+	int GetStateChanges();
+	int GetSavedChanges();
+	void free();
+};
+
+/*
+ * \brief Get the active render queues of renderers.
+ * \return The map from renderers to their render queues.
+ */
+inline std::unordered_map<SDL_Renderer*, RenderQueue*>& GetRenderQueues()
+{
+	static std::unordered_map<SDL_Renderer*, RenderQueue*> queues;
+	return queues;
+}
+
+/*
+ * \brief Get the active render queue of a renderer.
+ * \param renderer The renderer which textures draw on.
+ * \return The render queue, or NULL if textures draw immediately.
+ */
+inline RenderQueue* GetRenderQueue(SDL_Renderer* renderer)
+{
+	std::unordered_map<SDL_Renderer*, RenderQueue*>& queues = GetRenderQueues();
+	if (queues.empty())
+		return NULL;
+	auto found = queues.find(renderer);
+	return found == queues.end() ? NULL : found->second;
+}
+
+/*
+ * \brief Set the active render queue of a renderer.
+ * \param renderer The renderer which textures draw on.
+ * \param queue The render queue, or NULL to draw immediately.
+ */
+inline void SetRenderQueue(SDL_Renderer* renderer, RenderQueue* queue)
+{
+	if (queue == NULL)
+		GetRenderQueues().erase(renderer);
+	else
+		GetRenderQueues()[renderer] = queue;
+}
+
+/*
+ * \brief Draw the copies queued on a renderer, before drawing on it directly, changing its render target,
+ * or destroying a texture which may be queued.
+ * \param renderer The renderer which textures draw on.
+ */
+inline void FlushRenderQueue(SDL_Renderer* renderer)
+{
+	RenderQueue* queue = GetRenderQueue(renderer);
+	if (queue != NULL)
+		queue->Flush();
+}
+
+/*
+ * \brief Create an empty render queue.
+ */
+inline RenderQueue::RenderQueue()
+{
+	rend = NULL;
+	layer = 0;
+	depth = 0;
+	calls = 0;
+	changes = 0;
+	saved = 0;
+}
+
+/*
+ * \brief Deallocate the render queue.
+ */
+inline RenderQueue::~RenderQueue()
+{
+	free();
+}
+
+/*
+ * \brief Start queueing the copies of textures drawn on a renderer, instead of drawing them immediately.
+ * Drawing through Window::Redraw, begin and end the queue inside the drawing function, since each dirty rect is drawn on its own.
+ * \param renderer The renderer which textures draw on.
+ */
+inline void RenderQueue::Begin(SDL_Renderer* renderer)
+{
+	if (rend != NULL && rend != renderer)
+		End();
+	rend = renderer;
+	SetRenderQueue(rend, this);
+	layer = 0;
+	depth = 0;
+	calls = 0;
+	changes = 0;
+	saved = 0;
+}
+
+/*
+ * \brief Set the layer of the following copies. Layers are drawn in increasing order.
+ * \param layer The layer from 0 to 127.
+ */
+inline void RenderQueue::SetLayer(int layer)
+{
+	this->layer = layer < 0 ? 0 : layer > 127 ? 127 : layer;
+}
+
+/*
+ * \brief Set the depth of the following copies. In a layer, copies are drawn in increasing depth, and in the order of queueing at the same depth.
+ * A copy may still be drawn earlier to share a draw call with the same texture and blend mode, but never ahead of a copy it overlaps.
+ * \param depth The depth from -32768 to 32767.
+ */
+inline void RenderQueue::SetDepth(int depth)
+{
+	this->depth = depth < -32768 ? -32768 : depth > 32767 ? 32767 : depth;
+}
+
+/*
+ * \brief Queue a quad of a texture.
+ * \param texture The texture.
+ * \param clip A pointer to the portion of the texture, or NULL for the entire texture.
+ * \param corners The destination corners, clockwise from the top left one.
+ * \param flip A way in which flipping actions should be performed on the texture.
+ * \param color The color and alpha multiplied into the copy.
+ * \param blend The blend mode of the copy.
+ */
+inline void RenderQueue::Add(SDL_Texture* texture, const SDL_Rect* clip, const SDL_FPoint corners[4], SDL_RendererFlip flip, SDL_Color color, SDL_BlendMode blend)
+{
+	//Geometry without a texture would be drawn as filled quads.
+	if (texture == NULL)
+		return;
+	if (commands.size() == MaxCommands)
+		Flush();
+	RenderCommand command;
+	auto found = ids.find(texture);
+	if (found == ids.end())
+	{
+		command.id = (int)textures.size();
+		ids[texture] = command.id;
+		textures.push_back(texture);
+	}
+	else
+		command.id = found->second;
+	command.color = color;
+	command.blend = blend;
+	int w = 0, h = 0;
+	SDL_QueryTexture(texture, NULL, NULL, &w, &h);
+	SDL_Rect rect = { 0,0,w,h };
+	if (clip != NULL)
+		rect = *clip;
+	float u0 = w > 0 ? (float)rect.x / w : 0, u1 = w > 0 ? (float)(rect.x + rect.w) / w : 0;
+	float v0 = h > 0 ? (float)rect.y / h : 0, v1 = h > 0 ? (float)(rect.y + rect.h) / h : 0;
+	if (flip & SDL_FLIP_HORIZONTAL)
+	{
+		float u = u0;
+		u0 = u1;
+		u1 = u;
+	}
+	if (flip & SDL_FLIP_VERTICAL)
+	{
+		float v = v0;
+		v0 = v1;
+		v1 = v;
+	}
+	command.uv[0] = { u0,v0 };
+	command.uv[1] = { u1,v1 };
+	for (int i = 0; i < 4; i++)
+		command.corners[i] = corners[i];
+	//From the highest bits: layer, depth, and the order of queueing, which makes every key unique.
+	//Textures are grouped only when flushing, where the bounds of the copies show which ones may be reordered.
+	keys.push_back((Uint64)layer << 56 | (Uint64)(depth + 32768) << 40 | commands.size());
+	commands.push_back(command);
+}
+
+/*
+ * \brief Take the color, alpha and blend mode of a texture now, since the texture may be changed again before flushing.
+ */
+inline void RenderQueue::GetState(SDL_Texture* texture, SDL_Color& color, SDL_BlendMode& blend)
+{
+	color = { 255,255,255,255 };
+	blend = SDL_BLENDMODE_NONE;
+	SDL_GetTextureColorMod(texture, &color.r, &color.g, &color.b);
+	SDL_GetTextureAlphaMod(texture, &color.a);
+	SDL_GetTextureBlendMode(texture, &blend);
+}
+
+/*
+ * \brief Queue a copy of a texture, like SDL_RenderCopy.
+ * \param texture The texture.
+ * \param clip A pointer to the portion of the texture, or NULL for the entire texture.
+ * \param viewport A pointer to the destination coordinate and size.
+ */
+inline void RenderQueue::Copy(SDL_Texture* texture, const SDL_Rect* clip, const SDL_Rect* viewport)
+{
+	float l = (float)viewport->x, t = (float)viewport->y;
+	float r = (float)(viewport->x + viewport->w), b = (float)(viewport->y + viewport->h);
+	SDL_FPoint corners[4] = { { l,t },{ r,t },{ r,b },{ l,b } };
+	SDL_Color color;
+	SDL_BlendMode blend;
+	GetState(texture, color, blend);
+	Add(texture, clip, corners, SDL_FLIP_NONE, color, blend);
+}
+
+/*
+ * \brief Queue a rotated or flipped copy of a texture, like SDL_RenderCopyEx.
+ * \param texture The texture.
+ * \param clip A pointer to the portion of the texture, or NULL for the entire texture.
+ * \param viewport A pointer to the destination coordinate and size.
+ * \param angle An angle in degrees that indicates the rotation that will be applied to viewport, rotating it in a clockwise direction.
+ * \param center A pointer to the rotating center relative to the viewport, or NULL for the center of the viewport.
+ * \param flip A way in which flipping actions should be performed on the texture.
+ */
+inline void RenderQueue::CopyEx(SDL_Texture* texture, const SDL_Rect* clip, const SDL_Rect* viewport, double angle, const SDL_Point* center, SDL_RendererFlip flip)
+{
+	SDL_Color color;
+	SDL_BlendMode blend;
+	GetState(texture, color, blend);
+	CopyEx(texture, clip, viewport, angle, center, flip, color, blend);
+}
+
+/*
+ * \brief Queue a rotated or flipped copy of a texture with its own color, alpha and blend mode instead of the ones of the texture,
+ * such as a copy recorded on another thread.
+ * \param texture The texture.
+ * \param clip A pointer to the portion of the texture, or NULL for the entire texture.
+ * \param viewport A pointer to the destination coordinate and size.
+ * \param angle An angle in degrees that indicates the rotation that will be applied to viewport, rotating it in a clockwise direction.
+ * \param center A pointer to the rotating center relative to the viewport, or NULL for the center of the viewport.
+ * \param flip A way in which flipping actions should be performed on the texture.
+ * \param color The color and alpha multiplied into the copy.
+ * \param blend The blend mode of the copy.
+ */
+inline void RenderQueue::CopyEx(SDL_Texture* texture, const SDL_Rect* clip, const SDL_Rect* viewport, double angle, const SDL_Point* center, SDL_RendererFlip flip, SDL_Color color, SDL_BlendMode blend)
+{
+	double radian = angle * 3.14159265358979323846 / 180;
+	double c = cos(radian), s = sin(radian);
+	double cx = viewport->x + (center != NULL ? center->x : viewport->w / 2.0);
+	double cy = viewport->y + (center != NULL ? center->y : viewport->h / 2.0);
+	double x[4] = { (double)viewport->x,(double)viewport->x + viewport->w,(double)viewport->x + viewport->w,(double)viewport->x };
+	double y[4] = { (double)viewport->y,(double)viewport->y,(double)viewport->y + viewport->h,(double)viewport->y + viewport->h };
+	SDL_FPoint corners[4];
+	for (int i = 0; i < 4; i++)
+	{
+		double dx = x[i] - cx, dy = y[i] - cy;
+		corners[i] = { (float)(cx + dx * c - dy * s),(float)(cy + dx * s + dy * c) };
+	}
+	Add(texture, clip, corners, flip, color, blend);
+}
+
+/*
+ * \brief Get the number of copies queued since the last flush.
+ * \return The number of copies.
+ */
+inline int RenderQueue::Size()
+{
+	return (int)commands.size();
+}
+
+/*
+ * \brief Sort the keys with a least significant digit radix sort, a byte at a time.
+ */
+inline void RenderQueue::Sort()
+{
+	sorted.resize(keys.size());
+	for (int shift = 0; shift < 64; shift += 8)
+	{
+		int count[256] = { 0 };
+		for (int i = 0; i < keys.size(); i++)
+			count[(keys[i] >> shift) & 255]++;
+		//A byte shared by all keys, such as the layer of a single layer, leaves the order as it is.
+		if (count[(keys[0] >> shift) & 255] == keys.size())
+			continue;
+		int sum = 0;
+		for (int i = 0; i < 256; i++)
+		{
+			int n = count[i];
+			count[i] = sum;
+			sum += n;
+		}
+		for (int i = 0; i < keys.size(); i++)
+			sorted[count[(keys[i] >> shift) & 255]++] = keys[i];
+		keys.swap(sorted);
+	}
+}
+
+/*
+ * \brief Get the bounding box of the corners of a copy.
+ */
+inline SDL_FRect RenderQueue::Bound(const RenderCommand& command)
+{
+	float l = command.corners[0].x, t = command.corners[0].y, r = l, b = t;
+	for (int i = 1; i < 4; i++)
+	{
+		l = command.corners[i].x < l ? command.corners[i].x : l;
+		t = command.corners[i].y < t ? command.corners[i].y : t;
+		r = command.corners[i].x > r ? command.corners[i].x : r;
+		b = command.corners[i].y > b ? command.corners[i].y : b;
+	}
+	return { l,t,r - l,b - t };
+}
+
+/*
+ * \brief Determine if two bounding boxes share any area. Boxes which only touch don't cover the same pixels.
+ */
+inline bool RenderQueue::Overlap(const SDL_FRect& a, const SDL_FRect& b)
+{
+	return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+/*
+ * \brief Add the quad of a copy to the run being merged.
+ */
+inline void RenderQueue::Append(const RenderCommand& command)
+{
+	//Geometry takes the color and alpha of its vertices instead of the ones of its texture.
+	const SDL_FPoint* uv = command.uv;
+	int base = (int)vertices.size();
+	vertices.push_back({ command.corners[0],command.color,{ uv[0].x,uv[0].y } });
+	vertices.push_back({ command.corners[1],command.color,{ uv[1].x,uv[0].y } });
+	vertices.push_back({ command.corners[2],command.color,{ uv[1].x,uv[1].y } });
+	vertices.push_back({ command.corners[3],command.color,{ uv[0].x,uv[1].y } });
+	int order[6] = { 0,1,2,0,2,3 };
+	for (int i = 0; i < 6; i++)
+		indices.push_back(base + order[i]);
+}
+
+/*
+ * \brief Submit the merged quads of a texture in a single draw call.
+ * \param id The number of the texture.
+ */
+inline void RenderQueue::Submit(int id)
+{
+	if (indices.empty())
+		return;
+	if (SDL_RenderGeometry(rend, textures[id], vertices.data(), (int)vertices.size(), indices.data(), (int)indices.size()) != 0)
+		SDL_ReportError("SDL_RenderGeometry");
+	calls++;
+	vertices.clear();
+	indices.clear();
+}
+
+/*
+ * \brief Draw the queued copies sorted by their keys, merging the ones sharing a texture and a blend mode into a single draw call.
+ * A run takes the copies in a row, and later copies within LookAhead which overlap none of the copies they would skip,
+ * so that overlapping copies keep their order. The copies are drawn on the render target and in the clip rect set now.
+ */
+inline void RenderQueue::Flush()
+{
+	PROFILE_ZONE("RenderQueue::Flush");
+	if (commands.empty())
+		return;
+	//Count the switches which drawing in the order of queueing would make.
+	int unsorted = 0;
+	for (int i = 1; i < commands.size(); i++)
+		if (commands[i].id != commands[i - 1].id || commands[i].blend != commands[i - 1].blend)
+			unsorted++;
+	Sort();
+	original.resize(textures.size());
+	for (int i = 0; i < textures.size(); i++)
+		SDL_GetTextureBlendMode(textures[i], &original[i]);
+	blends = original;
+	taken.assign(keys.size(), 0);
+	int id = -1, switches = 0;
+	SDL_BlendMode blend = SDL_BLENDMODE_NONE;
+	for (int i = 0; i < keys.size(); i++)
+	{
+		if (taken[i])
+			continue;
+		const RenderCommand& command = commands[keys[i] & (MaxCommands - 1)];
+		if (command.id == id && command.blend == blend)
+		{
+			Append(command);
+			continue;
+		}
+		Submit(id);
+		if (id >= 0)
+			switches++;
+		id = command.id;
+		blend = command.blend;
+		//Geometry is drawn with the blend mode of its texture.
+		if (blends[id] != blend)
+		{
+			if (SDL_SetTextureBlendMode(textures[id], blend) != 0)
+				SDL_ReportError("SDL_SetTextureBlendMode");
+			blends[id] = blend;
+		}
+		Append(command);
+		//Pull later copies of the run into it, unless they overlap a copy which they would then be drawn under.
+		skipped.clear();
+		int looked = 0;
+		for (int j = i + 1; j < keys.size() && looked < LookAhead; j++)
+		{
+			if (taken[j])
+				continue;
+			looked++;
+			const RenderCommand& next = commands[keys[j] & (MaxCommands - 1)];
+			SDL_FRect bound = Bound(next);
+			bool joins = next.id == id && next.blend == blend;
+			for (int k = 0; joins && k < skipped.size(); k++)
+				if (Overlap(bound, skipped[k]))
+					joins = false;
+			if (joins)
+			{
+				Append(next);
+				taken[j] = 1;
+			}
+			else
+				skipped.push_back(bound);
+		}
+	}
+	Submit(id);
+	for (int i = 0; i < textures.size(); i++)
+		if (blends[i] != original[i])
+			SDL_SetTextureBlendMode(textures[i], original[i]);
+	changes += switches;
+	saved += unsorted - switches;
+	//Keep the capacity, so that the following frames don't allocate.
+	commands.clear();
+	keys.clear();
+	textures.clear();
+	ids.clear();
+}
+
+/*
+ * \brief Draw the queued copies, and go back to drawing textures immediately.
+ * \return The number of draw calls issued since Begin().
+ */
+inline int RenderQueue::End()
+{
+	Flush();
+	if (rend != NULL && GetRenderQueue(rend) == this)
+		SetRenderQueue(rend, NULL);
+	rend = NULL;
+	return calls;
+}
+
+/*
+ * \brief Get the number of draw calls issued since Begin().
+ * \return The number of draw calls.
+ */
+inline int RenderQueue::GetDrawCalls()
+{
+	return calls;
+}
+
+/*
+ * \brief Get the number of texture and blend mode switches made since Begin().
+ * \return The number of switches.
+ */
+inline int RenderQueue::GetStateChanges()
+{
+	return changes;
+}
+
+/*
+ * \brief Get the number of texture and blend mode switches saved by sorting since Begin(), compared with drawing in the order of queueing.
+ * It may be negative when layers or depths force switches which the order of queueing wouldn't make.
+ * \return The number of switches.
+ */
+inline int RenderQueue::GetSavedChanges()
+{
+	return saved;
+}
+
+/*
+ * \brief Drop the queued copies without drawing them, and deallocate the buffers of the render queue.
+ */
+inline void RenderQueue::free()
+{
+	if (rend != NULL && GetRenderQueue(rend) == this)
+		SetRenderQueue(rend, NULL);
+	rend = NULL;
+	std::vector<RenderCommand>().swap(commands);
+	std::vector<Uint64>().swap(keys);
+	std::vector<Uint64>().swap(sorted);
+	std::vector<SDL_Texture*>().swap(textures);
+	ids.clear();
+	std::vector<SDL_BlendMode>().swap(original);
+	std::vector<SDL_BlendMode>().swap(blends);
+	std::vector<SDL_Vertex>().swap(vertices);
+	std::vector<int>().swap(indices);
+	std::vector<char>().swap(taken);
+	std::vector<SDL_FRect>().swap(skipped);
+	layer = 0;
+	depth = 0;
+	calls = 0;
+	changes = 0;
+	saved = 0;
+}
+
+
+#endif // !renderqueue_h_
\ No newline at end of file
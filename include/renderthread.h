@@ -0,0 +1,511 @@
+#ifndef renderthread_h_
+#define renderthread_h_
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+#include <SDL.h>
+#include <window.h>
+#include <texture.h>
+#include <renderqueue.h>
+#include <profiler.h>
+#include <error.h>
+
+//A copy of a texture recorded in a frame snapshot.
+struct FrameCopy
+{
+	SDL_Texture* texture;
+	//An empty clip stands for the entire texture.
+	SDL_Rect clip;
+	SDL_Rect viewport;
+	double angle;
+	SDL_Point center;
+	SDL_RendererFlip flip;
+	SDL_Color color;
+	SDL_BlendMode blend;
+	int layer, depth;
+};
+
+//Frame snapshot wrapper class
+class FrameSnapshot
+{
+private:
+	std::vector<FrameCopy> copies;
+	//The state given to the following copies.
+	SDL_Color color;
+	SDL_BlendMode blend;
+	int layer, depth;
+public:
+	FrameSnapshot();
+	~FrameSnapshot();
+	void Reset();
+	void SetColor(Uint8 r, Uint8 g, Uint8 b);
+	void SetAlpha(Uint8 alpha);
+	void SetBlend(SDL_BlendMode blendmode);
+	void SetLayer(int layer);
+	void SetDepth(int depth);
+	void Clear(Texture& texture, SDL_Point point, SDL_Rect* clip = NULL);
+	void RenderEx(Texture& texture, SDL_Point point, double angle, SDL_Point center, SDL_RendererFlip flip, SDL_Rect* clip = NULL);
+	void RenderStretched(Texture& texture, SDL_Rect viewport, SDL_Rect* clip = NULL);
+	int Size();
+	void Replay(RenderQueue& queue);
+	void free();
+};
+
+/*
+ * \brief Create an empty frame snapshot.
+ */
+inline FrameSnapshot::FrameSnapshot()
+{
+	color = { 255,255,255,255 };
+	blend = SDL_BLENDMODE_BLEND;
+	layer = 0;
+	depth = 0;
+}
+
+/*
+ * \brief Deallocate the frame snapshot.
+ */
+inline FrameSnapshot::~FrameSnapshot()
+{
+	free();
+}
+
+/*
+ * \brief Remove the copies for recording another frame, keeping the capacity, and reset the state.
+ */
+inline void FrameSnapshot::Reset()
+{
+	copies.clear();
+	color = { 255,255,255,255 };
+	blend = SDL_BLENDMODE_BLEND;
+	layer = 0;
+	depth = 0;
+}
+
+/*
+ * \brief Set an additional color value multiplied into the following copies.
+ * \param r The red color value.
+ * \param g The green color value.
+ * \param b The blue color value.
+ */
+inline void FrameSnapshot::SetColor(Uint8 r, Uint8 g, Uint8 b)
+{
+	color.r = r;
+	color.g = g;
+	color.b = b;
+}
+
+/*
+ * \brief Set the transparency of the following copies.
+ * \param alpha The alpha value multiplied into the following copies.
+ */
+inline void FrameSnapshot::SetAlpha(Uint8 alpha)
+{
+	color.a = alpha;
+}
+
+/*
+ * \brief Set the blend mode of the following copies, which is SDL_BLENDMODE_BLEND after Reset().
+ * \param blendmode The blend mode.
+ */
+inline void FrameSnapshot::SetBlend(SDL_BlendMode blendmode)
+{
+	blend = blendmode;
+}
+
+/*
+ * \brief Set the layer of the following copies, like RenderQueue::SetLayer.
+ * \param layer The layer from 0 to 127.
+ */
+inline void FrameSnapshot::SetLayer(int layer)
+{
+	this->layer = layer;
+}
+
+/*
+ * \brief Set the depth of the following copies, like RenderQueue::SetDepth.
+ * \param depth The depth from -32768 to 32767.
+ */
+inline void FrameSnapshot::SetDepth(int depth)
+{
+	this->depth = depth;
+}
+
+/*
+ * \brief Record a copy of a portion of a texture, like Texture::Clear.
+ * \param texture The texture, which must stay alive until the render thread stops.
+ * \param point The destination coordinate to copy the texture.
+ * \param clip A pointer to the portion of source texture, or NULL for the entire texture.
+ */
+inline void FrameSnapshot::Clear(Texture& texture, SDL_Point point, SDL_Rect* clip)
+{
+	SDL_Rect viewport = { point.x,point.y,texture.GetWidth(),texture.GetHeight() };
+	if (clip != NULL)
+	{
+		viewport.w = clip->w;
+		viewport.h = clip->h;
+	}
+	RenderStretched(texture, viewport, clip);
+}
+
+/*
+ * \brief Record a rotated or flipped copy of a portion of a texture, like Texture::RenderEx.
+ * \param texture The texture, which must stay alive until the render thread stops.
+ * \param point The destination coordinate to copy the texture.
+ * \param angle An angle in degrees that indicates the rotation that will be applied to viewport, rotating it in a clockwise direction.
+ * \param center The rotating center.
+ * \param flip A way in which flipping actions should be performed on the texture.
+ * \param clip A pointer to the portion of source texture, or NULL for the entire texture.
+ */
+inline void FrameSnapshot::RenderEx(Texture& texture, SDL_Point point, double angle, SDL_Point center, SDL_RendererFlip flip, SDL_Rect* clip)
+{
+	SDL_Rect viewport = { point.x,point.y,texture.GetWidth(),texture.GetHeight() };
+	if (clip != NULL)
+	{
+		viewport.w = clip->w;
+		viewport.h = clip->h;
+	}
+	copies.push_back({ texture.GetTexture(),clip != NULL ? *clip : SDL_Rect{ 0,0,0,0 },viewport,angle,center,flip,color,blend,layer,depth });
+}
+
+/*
+ * \brief Record a stretched copy of a portion of a texture, like Texture::RenderStretched.
+ * \param texture The texture, which must stay alive until the render thread stops.
+ * \param viewport The destination coordinate and size to copy the texture.
+ * \param clip A pointer to the portion of source texture, or NULL for the entire texture.
+ */
+inline void FrameSnapshot::RenderStretched(Texture& texture, SDL_Rect viewport, SDL_Rect* clip)
+{
+	copies.push_back({ texture.GetTexture(),clip != NULL ? *clip : SDL_Rect{ 0,0,0,0 },viewport,0,{ 0,0 },SDL_FLIP_NONE,color,blend,layer,depth });
+}
+
+/*
+ * \brief Get the number of copies recorded.
+ * \return The number of copies.
+ */
+inline int FrameSnapshot::Size()
+{
+	return (int)copies.size();
+}
+
+/*
+ * \brief Queue the recorded copies into a render queue, which draws them sorted when it flushes.
+ * \param queue The render queue.
+ */
+inline void FrameSnapshot::Replay(RenderQueue& queue)
+{
+	for (int i = 0; i < copies.size(); i++)
+	{
+		const FrameCopy& copy = copies[i];
+		queue.SetLayer(copy.layer);
+		queue.SetDepth(copy.depth);
+		queue.CopyEx(copy.texture, copy.clip.w != 0 ? &copy.clip : NULL, &copy.viewport, copy.angle, &copy.center, copy.flip, copy.color, copy.blend);
+	}
+}
+
+/*
+ * \brief Deallocate the copies of the frame snapshot.
+ */
+inline void FrameSnapshot::free()
+{
+	std::vector<FrameCopy>().swap(copies);
+	color = { 255,255,255,255 };
+	blend = SDL_BLENDMODE_BLEND;
+	layer = 0;
+	depth = 0;
+}
+
+//Render thread wrapper class
+class RenderThread
+{
+private:
+	Window* window;
+	//A triple buffer: the simulation records into the back frame, the render thread draws the front frame,
+	//and they swap their frames with the middle one, which holds the latest frame published.
+	FrameSnapshot frames[3];
+	std::atomic<int> middle;
+	int back, front;
+	//A ring of events from the render thread to the simulation, with one writer and one reader.
+	std::vector<SDL_Event> events;
+	std::atomic<Uint32> head, tail;
+	std::thread simulation;
+	std::atomic<bool> running;
+	bool quit;
+	RenderQueue queue;
+	std::atomic<Uint64> published;
+	Uint64 presented;
+	std::atomic<Uint64> dropped;
+	//The bit of the middle frame set when it was published and hasn't been presented.
+	static const int Fresh = 4;
+public:
+	//The largest number of events waiting for the simulation, which must be a power of 2.
+	static const int RingSize = 1024;
+	RenderThread();
+	~RenderThread();
+	bool Start(Window& window, std::function<void(RenderThread&)> simulate);
+	bool IsRunning();
+	void Stop();
+	int PumpEvents();
+	bool PushEvent(const SDL_Event& event);
+	bool QuitRequested();
+	bool Present();
+	bool PollEvent(SDL_Event& event);
+	FrameSnapshot& GetFrame();
+	void Publish();
+	Uint64 GetPublished();
+	Uint64 GetPresented();
+	Uint64 GetDroppedEvents();
+	RenderQueue& GetQueue();
+	void free();
+};
+
+/*
+ * \brief Create a render thread which isn't started.
+ */
+inline RenderThread::RenderThread()
+{
+	window = NULL;
+	middle = 1;
+	back = 0;
+	front = 2;
+	events.resize(RingSize);
+	head = 0;
+	tail = 0;
+	running = false;
+	quit = false;
+	published = 0;
+	presented = 0;
+	dropped = 0;
+}
+
+/*
+ * \brief Stop the simulation and deallocate the render thread.
+ */
+inline RenderThread::~RenderThread()
+{
+	free();
+}
+
+/*
+ * \brief Start running the simulation on a thread of its own, and make the calling thread the render thread.
+ * The render thread owns the window and its renderer, takes the events and presents the frames, since SDL wants them on the thread
+ * which created the window. The simulation records frames instead of drawing, and must not touch the renderer.
+ * \param window The window drawn on, which must be created by the calling thread and stay alive until the render thread stops.
+ * \param simulate The function run by the simulation thread, which should poll events, record frames and publish them until IsRunning() turns 0.
+ * \return 1 if succeeded, or 0 if the simulation had been started.
+ */
+inline bool RenderThread::Start(Window& window, std::function<void(RenderThread&)> simulate)
+{
+	if (simulation.joinable())
+		return 0;
+	this->window = &window;
+	for (int i = 0; i < 3; i++)
+		frames[i].Reset();
+	middle = 1;
+	back = 0;
+	front = 2;
+	head = 0;
+	tail = 0;
+	quit = false;
+	published = 0;
+	presented = 0;
+	dropped = 0;
+	running = true;
+	simulation = std::thread([this, simulate] { simulate(*this); });
+	return 1;
+}
+
+/*
+ * \brief Determine if the simulation should keep running, such as in the loop of the simulation.
+ * \return 1 if running, or 0 if Stop() has been called.
+ */
+inline bool RenderThread::IsRunning()
+{
+	return running.load(std::memory_order_acquire);
+}
+
+/*
+ * \brief Ask the simulation to return, and wait for it. Call it on the render thread.
+ */
+inline void RenderThread::Stop()
+{
+	running.store(false, std::memory_order_release);
+	if (simulation.joinable())
+		simulation.join();
+}
+
+/*
+ * \brief Take all events from the queue in bulk on the render thread, let the window handle them, and pass them on to the simulation.
+ * \return The number of events taken.
+ */
+inline int RenderThread::PumpEvents()
+{
+	PROFILE_ZONE("RenderThread::PumpEvents");
+	SDL_PumpEvents();
+	SDL_Event buffer[64];
+	int total = 0;
+	while (1)
+	{
+		int count = SDL_PeepEvents(buffer, 64, SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+		if (count < 0)
+		{
+			SDL_ReportError("SDL_PeepEvents");
+			break;
+		}
+		for (int i = 0; i < count; i++)
+		{
+			if (buffer[i].type == SDL_QUIT)
+				quit = true;
+			if (window != NULL)
+				window->HandleEvent(buffer[i]);
+			PushEvent(buffer[i]);
+		}
+		total += count;
+		if (count < 64)
+			break;
+	}
+	return total;
+}
+
+/*
+ * \brief Pass an event to the simulation. Call it on the render thread.
+ * \param event The event.
+ * \return 1 if succeeded, or 0 if the ring is full and the event is dropped.
+ */
+inline bool RenderThread::PushEvent(const SDL_Event& event)
+{
+	Uint32 h = head.load(std::memory_order_relaxed);
+	if (h - tail.load(std::memory_order_acquire) == RingSize)
+	{
+		dropped++;
+		return 0;
+	}
+	events[h & (RingSize - 1)] = event;
+	head.store(h + 1, std::memory_order_release);
+	return 1;
+}
+
+/*
+ * \brief Determine if a quit event has been taken by PumpEvents().
+ * \return 1 if quit is requested, or 0 if not.
+ */
+inline bool RenderThread::QuitRequested()
+{
+	return quit;
+}
+
+/*
+ * \brief Draw and present the latest frame published, on the render thread. Frames published meanwhile are skipped,
+ * and nothing is drawn if no frame has been published since the last call, so that the simulation never waits for vsync.
+ * \return 1 if a frame is presented, or 0 if not.
+ */
+inline bool RenderThread::Present()
+{
+	PROFILE_ZONE("RenderThread::Present");
+	if (window == NULL || !(middle.load(std::memory_order_acquire) & Fresh))
+		return 0;
+	front = middle.exchange(front, std::memory_order_acq_rel) & (Fresh - 1);
+	if (!window->IsShown() || window->IsMinimized())
+		return 0;
+	window->Clear();
+	queue.Begin(window->GetRenderer());
+	frames[front].Replay(queue);
+	queue.End();
+	window->Present();
+	presented++;
+	return 1;
+}
+
+/*
+ * \brief Take an event passed on by the render thread. Call it on the simulation thread.
+ * \param event The event taken.
+ * \return 1 if an event is taken, or 0 if there are none.
+ */
+inline bool RenderThread::PollEvent(SDL_Event& event)
+{
+	Uint32 t = tail.load(std::memory_order_relaxed);
+	if (t == head.load(std::memory_order_acquire))
+		return 0;
+	event = events[t & (RingSize - 1)];
+	tail.store(t + 1, std::memory_order_release);
+	return 1;
+}
+
+/*
+ * \brief Get the frame being recorded. Call it on the simulation thread.
+ * \return The frame, which is empty after Publish().
+ */
+inline FrameSnapshot& RenderThread::GetFrame()
+{
+	return frames[back];
+}
+
+/*
+ * \brief Hand the recorded frame to the render thread without waiting, and start recording an empty one. Call it on the simulation thread.
+ */
+inline void RenderThread::Publish()
+{
+	back = middle.exchange(back | Fresh, std::memory_order_acq_rel) & (Fresh - 1);
+	//The frame taken back is either one which was never presented, or one which the render thread is done with.
+	frames[back].Reset();
+	published++;
+}
+
+/*
+ * \brief Get the number of frames published since Start().
+ * \return The number of frames.
+ */
+inline Uint64 RenderThread::GetPublished()
+{
+	return published;
+}
+
+/*
+ * \brief Get the number of frames presented since Start(). The frames published but not presented were skipped.
+ * \return The number of frames.
+ */
+inline Uint64 RenderThread::GetPresented()
+{
+	return presented;
+}
+
+/*
+ * \brief Get the number of events dropped since Start(), because the simulation didn't poll them in time.
+ * \return The number of events.
+ */
+inline Uint64 RenderThread::GetDroppedEvents()
+{
+	return dropped;
+}
+
+/*
+ * \brief Get the render queue drawing the frames, such as for its statistics.
+ * \return The render queue.
+ */
+inline RenderQueue& RenderThread::GetQueue()
+{
+	return queue;
+}
+
+/*
+ * \brief Stop the simulation, and deallocate the frames and the render queue.
+ */
+inline void RenderThread::free()
+{
+	Stop();
+	for (int i = 0; i < 3; i++)
+		frames[i].free();
+	queue.free();
+	window = NULL;
+	middle = 1;
+	back = 0;
+	front = 2;
+	head = 0;
+	tail = 0;
+	quit = false;
+}
+
+
+#endif // !renderthread_h_
\ No newline at end of file
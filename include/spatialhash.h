@@ -0,0 +1,383 @@
+#ifndef spatialhash_h_
+#define spatialhash_h_
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <unordered_map>
+#include <SDL.h>
+#include <collision.h>
+
+//Spatial hash wrapper class (broad phase of collision detection)
+class SpatialHash
+{
+private:
+	int size;
+	//Every cell keeps the numbers of boxes overlapping it.
+	std::unordered_map<Sint64, std::vector<int>> cells;
+	std::vector<SDL_Rect> boxes;
+	//The range of cells covered by each box, stored as { first column, first row, last column, last row }.
+	std::vector<SDL_Rect> spans;
+	std::vector<bool> used;
+	std::vector<int> unused;
+	//Mark the boxes already reported during a query.
+	std::vector<Uint32> marks;
+	Uint32 mark;
+	int number;
+	Sint64 Key(int column, int row);
+	int Cell(int coordinate);
+	SDL_Rect Span(SDL_Rect rect);
+	void Link(int id, SDL_Rect span);
+	void Unlink(int id, SDL_Rect span);
+	void NextMark();
+public:
+	SpatialHash();
+	SpatialHash(int size);
+	~SpatialHash();
+	void SetCellSize(int size);
+	int Insert(SDL_Rect rect);
+	void Update(int id, SDL_Rect rect);
+	void Remove(int id);
+	int Query(SDL_Rect rect, std::vector<int>& hits);
+	bool Collided(SDL_Rect rect);
+	int Pairs(std::vector<std::pair<int, int>>& pairs);
+	SDL_Rect GetBox(int id);
+	int GetCellSize();
+	int Size();
+	void free();
+};
+
+/*
+ * \brief Create an empty spatial hash with 64 * 64 cells.
+ */
+inline SpatialHash::SpatialHash()
+{
+	size = 64;
+	mark = 0;
+	number = 0;
+}
+
+/*
+ * \brief Create an empty spatial hash.
+ * \param size The width and height of a single cell, which should be close to the size of a typical box.
+ */
+inline SpatialHash::SpatialHash(int size)
+{
+	this->size = size > 0 ? size : 64;
+	mark = 0;
+	number = 0;
+}
+
+/*
+ * \brief Deallocate the spatial hash.
+ */
+inline SpatialHash::~SpatialHash()
+{
+	free();
+}
+
+/*
+ * \brief Change the size of cells, and rebuild the cells of all boxes.
+ * \param size The width and height of a single cell.
+ */
+inline void SpatialHash::SetCellSize(int size)
+{
+	if (size <= 0 || size == this->size)
+		return;
+	cells.clear();
+	this->size = size;
+	for (int i = 0; i < boxes.size(); i++)
+	{
+		if (used[i])
+		{
+			spans[i] = Span(boxes[i]);
+			Link(i, spans[i]);
+		}
+	}
+}
+
+/*
+ * \brief Combine the column and row of a cell into the key of hashing.
+ */
+inline Sint64 SpatialHash::Key(int column, int row)
+{
+	return ((Sint64)column << 32) | (Uint32)row;
+}
+
+/*
+ * \brief Get the column or row of the cell containing a coordinate.
+ */
+inline int SpatialHash::Cell(int coordinate)
+{
+	//Round towards negative infinity, so that negative coordinates work too.
+	if (coordinate >= 0)
+		return coordinate / size;
+	return (coordinate + 1) / size - 1;
+}
+
+/*
+ * \brief Get the range of cells covered by a rectangle.
+ */
+inline SDL_Rect SpatialHash::Span(SDL_Rect rect)
+{
+	int right = rect.w > 0 ? rect.x + rect.w - 1 : rect.x;
+	int bottom = rect.h > 0 ? rect.y + rect.h - 1 : rect.y;
+	return { Cell(rect.x),Cell(rect.y),Cell(right),Cell(bottom) };
+}
+
+/*
+ * \brief Add a box to every cell in the range.
+ */
+inline void SpatialHash::Link(int id, SDL_Rect span)
+{
+	for (int row = span.y; row <= span.h; row++)
+		for (int column = span.x; column <= span.w; column++)
+			cells[Key(column, row)].push_back(id);
+}
+
+/*
+ * \brief Remove a box from every cell in the range.
+ */
+inline void SpatialHash::Unlink(int id, SDL_Rect span)
+{
+	for (int row = span.y; row <= span.h; row++)
+	{
+		for (int column = span.x; column <= span.w; column++)
+		{
+			auto cell = cells.find(Key(column, row));
+			if (cell == cells.end())
+				continue;
+			std::vector<int>& list = cell->second;
+			for (int i = 0; i < list.size(); i++)
+			{
+				if (list[i] == id)
+				{
+					list[i] = list.back();
+					list.pop_back();
+					break;
+				}
+			}
+			if (list.empty())
+				cells.erase(cell);
+		}
+	}
+}
+
+/*
+ * \brief Start a new round of marks, so that every box is reported once in a query.
+ */
+inline void SpatialHash::NextMark()
+{
+	mark++;
+	//Clear the marks after the counter wraps around.
+	if (mark == 0)
+	{
+		std::fill(marks.begin(), marks.end(), 0);
+		mark = 1;
+	}
+}
+
+/*
+ * \brief Add a box to the spatial hash.
+ * \param rect The box to be added.
+ * \return The number of the box, used to update or remove it later.
+ */
+inline int SpatialHash::Insert(SDL_Rect rect)
+{
+	int id;
+	//Reuse the number of a removed box if possible.
+	if (!unused.empty())
+	{
+		id = unused.back();
+		unused.pop_back();
+		boxes[id] = rect;
+		spans[id] = Span(rect);
+		used[id] = true;
+		marks[id] = 0;
+	}
+	else
+	{
+		id = (int)boxes.size();
+		boxes.push_back(rect);
+		spans.push_back(Span(rect));
+		used.push_back(true);
+		marks.push_back(0);
+	}
+	Link(id, spans[id]);
+	number++;
+	return id;
+}
+
+/*
+ * \brief Move or resize a box. Cells are only touched when the box crosses a cell border.
+ * \param id The number of the box.
+ * \param rect The new position and size of the box.
+ */
+inline void SpatialHash::Update(int id, SDL_Rect rect)
+{
+	if (id < 0 || id >= boxes.size() || !used[id])
+		return;
+	boxes[id] = rect;
+	SDL_Rect span = Span(rect);
+	SDL_Rect& old = spans[id];
+	if (span.x != old.x || span.y != old.y || span.w != old.w || span.h != old.h)
+	{
+		Unlink(id, old);
+		Link(id, span);
+		old = span;
+	}
+}
+
+/*
+ * \brief Remove a box from the spatial hash.
+ * \param id The number of the box.
+ */
+inline void SpatialHash::Remove(int id)
+{
+	if (id < 0 || id >= boxes.size() || !used[id])
+		return;
+	Unlink(id, spans[id]);
+	used[id] = false;
+	unused.push_back(id);
+	number--;
+}
+
+/*
+ * \brief Find all boxes colliding externally with a rectangle.
+ * \param rect The target rectangle.
+ * \param hits A vector to which the numbers of colliding boxes are appended.
+ * \return The number of colliding boxes.
+ */
+inline int SpatialHash::Query(SDL_Rect rect, std::vector<int>& hits)
+{
+	int found = 0;
+	SDL_Rect span = Span(rect);
+	NextMark();
+	for (int row = span.y; row <= span.h; row++)
+	{
+		for (int column = span.x; column <= span.w; column++)
+		{
+			auto cell = cells.find(Key(column, row));
+			if (cell == cells.end())
+				continue;
+			for (int id : cell->second)
+			{
+				if (marks[id] == mark)
+					continue;
+				marks[id] = mark;
+				if (OutsideCollided(boxes[id], rect))
+				{
+					hits.push_back(id);
+					found++;
+				}
+			}
+		}
+	}
+	return found;
+}
+
+/*
+ * \brief Determine if any box collides externally with a rectangle.
+ * \param rect The target rectangle.
+ * \return 1 if collided, or 0 if not collided.
+ */
+inline bool SpatialHash::Collided(SDL_Rect rect)
+{
+	SDL_Rect span = Span(rect);
+	for (int row = span.y; row <= span.h; row++)
+	{
+		for (int column = span.x; column <= span.w; column++)
+		{
+			auto cell = cells.find(Key(column, row));
+			if (cell == cells.end())
+				continue;
+			for (int id : cell->second)
+				if (OutsideCollided(boxes[id], rect))
+					return 1;
+		}
+	}
+	return 0;
+}
+
+/*
+ * \brief Find all pairs of boxes colliding externally with each other.
+ * \param pairs A vector to which the colliding pairs are appended, with the smaller number first.
+ * \return The number of colliding pairs.
+ */
+inline int SpatialHash::Pairs(std::vector<std::pair<int, int>>& pairs)
+{
+	int found = 0;
+	for (auto& cell : cells)
+	{
+		const std::vector<int>& list = cell.second;
+		int column = (int)(cell.first >> 32);
+		int row = (int)(Uint32)cell.first;
+		for (int i = 0; i < list.size(); i++)
+		{
+			const SDL_Rect& a = boxes[list[i]];
+			for (int j = i + 1; j < list.size(); j++)
+			{
+				const SDL_Rect& b = boxes[list[j]];
+				if (!OutsideCollided(a, b))
+					continue;
+				//Report the pair only in the cell holding the top left corner of the overlapping area.
+				if (Cell(a.x > b.x ? a.x : b.x) != column || Cell(a.y > b.y ? a.y : b.y) != row)
+					continue;
+				if (list[i] < list[j])
+					pairs.push_back({ list[i],list[j] });
+				else
+					pairs.push_back({ list[j],list[i] });
+				found++;
+			}
+		}
+	}
+	return found;
+}
+
+/*
+ * \brief Get the position and size of a box.
+ * \param id The number of the box.
+ * \return The box, or an empty rectangle if the number is invalid.
+ */
+inline SDL_Rect SpatialHash::GetBox(int id)
+{
+	if (id < 0 || id >= boxes.size() || !used[id])
+		return { 0,0,0,0 };
+	return boxes[id];
+}
+
+/*
+ * \brief Get the size of cells.
+ * \return The width and height of a single cell.
+ */
+inline int SpatialHash::GetCellSize()
+{
+	return size;
+}
+
+/*
+ * \brief Get the number of boxes in the spatial hash.
+ * \return The number of boxes.
+ */
+inline int SpatialHash::Size()
+{
+	return number;
+}
+
+/*
+ * \brief Remove all boxes from the spatial hash.
+ */
+inline void SpatialHash::free()
+{
+	cells.clear();
+	std::vector<SDL_Rect>().swap(boxes);
+	std::vector<SDL_Rect>().swap(spans);
+	std::vector<bool>().swap(used);
+	std::vector<int>().swap(unused);
+	std::vector<Uint32>().swap(marks);
+	mark = 0;
+	number = 0;
+}
+
+
+#endif // !spatialhash_h_
\ No newline at end of file
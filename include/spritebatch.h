@@ -0,0 +1,247 @@
+#ifndef spritebatch_h_
+#define spritebatch_h_
+
+#include <math.h>
+#include <vector>
+#include <SDL.h>
+#include <atlas.h>
+#include <renderqueue.h>
+#include <error.h>
+
+//Sprite batch wrapper class
+class SpriteBatch
+{
+private:
+	SDL_Renderer* rend;
+	Atlas* atlas;
+	//The quads collected since the last submission, all on the same page.
+	std::vector<SDL_Vertex> vertices;
+	std::vector<int> indices;
+	int page;
+	SDL_Color color;
+	int calls;
+	void Flush();
+	void Quad(int id, const SDL_FPoint corners[4], SDL_RendererFlip flip);
+public:
+	SpriteBatch();
+	~SpriteBatch();
+	void Begin(SDL_Renderer* renderer, Atlas& atlas);
+	void SetColor(Uint8 r, Uint8 g, Uint8 b);
+	void SetAlpha(Uint8 alpha);
+	SDL_Color GetColor();
+	void Clear(int id, SDL_Point point);
+	void RenderEx(int id, SDL_Point point, double angle, SDL_Point center, SDL_RendererFlip flip);
+	void RenderStretched(int id, SDL_Rect viewport);
+	int End();
+	int GetDrawCalls();
+	void free();
+};
+
+/*
+ * \brief Create an empty sprite batch.
+ */
+inline SpriteBatch::SpriteBatch()
+{
+	rend = NULL;
+	atlas = NULL;
+	page = -1;
+	color = { 255,255,255,255 };
+	calls = 0;
+}
+
+/*
+ * \brief Deallocate the sprite batch.
+ */
+inline SpriteBatch::~SpriteBatch()
+{
+	free();
+}
+
+/*
+ * \brief Start collecting sprites for a frame.
+ * \param renderer The renderer which should draw the sprites.
+ * \param atlas The atlas holding the images of sprites, which must have been built.
+ */
+inline void SpriteBatch::Begin(SDL_Renderer* renderer, Atlas& atlas)
+{
+	rend = renderer;
+	this->atlas = &atlas;
+	vertices.clear();
+	indices.clear();
+	page = -1;
+	color = { 255,255,255,255 };
+	calls = 0;
+}
+
+/*
+ * \brief Set an additional color value multiplied into the following sprites.
+ * \param r The red color value.
+ * \param g The green color value.
+ * \param b The blue color value.
+ */
+inline void SpriteBatch::SetColor(Uint8 r, Uint8 g, Uint8 b)
+{
+	color.r = r;
+	color.g = g;
+	color.b = b;
+}
+
+/*
+ * \brief Set the transparency of the following sprites.
+ * \param alpha The alpha value multiplied into the following sprites.
+ */
+inline void SpriteBatch::SetAlpha(Uint8 alpha)
+{
+	color.a = alpha;
+}
+
+/*
+ * \brief Get the color and alpha multiplied into the following sprites, such as for restoring them after changing them.
+ * \return The color, with the alpha in its a.
+ */
+inline SDL_Color SpriteBatch::GetColor()
+{
+	return color;
+}
+
+/*
+ * \brief Submit the collected quads in a single draw call, after the copies queued on the renderer which come before them.
+ */
+inline void SpriteBatch::Flush()
+{
+	if (!indices.empty())
+	{
+		FlushRenderQueue(rend);
+		if (SDL_RenderGeometry(rend, atlas->GetPage(page), vertices.data(), (int)vertices.size(), indices.data(), (int)indices.size()) != 0)
+			SDL_ReportError("SDL_RenderGeometry");
+		calls++;
+	}
+	//Keep the capacity, so that the following frames don't allocate.
+	vertices.clear();
+	indices.clear();
+}
+
+/*
+ * \brief Add a quad showing a packed image.
+ * \param id The number of the packed image.
+ * \param corners The destination corners, clockwise from the top left one.
+ * \param flip A way in which flipping actions should be performed on the image.
+ */
+inline void SpriteBatch::Quad(int id, const SDL_FPoint corners[4], SDL_RendererFlip flip)
+{
+	AtlasRegion region = atlas->GetRegion(id);
+	//Sprites are drawn in order, so a new page starts a new draw call.
+	if (region.page != page)
+	{
+		Flush();
+		page = region.page;
+	}
+	float size = (float)atlas->GetPageSize();
+	float u0 = region.rect.x / size, u1 = (region.rect.x + region.rect.w) / size;
+	float v0 = region.rect.y / size, v1 = (region.rect.y + region.rect.h) / size;
+	if (flip & SDL_FLIP_HORIZONTAL)
+	{
+		float u = u0;
+		u0 = u1;
+		u1 = u;
+	}
+	if (flip & SDL_FLIP_VERTICAL)
+	{
+		float v = v0;
+		v0 = v1;
+		v1 = v;
+	}
+	int base = (int)vertices.size();
+	vertices.push_back({ corners[0],color,{ u0,v0 } });
+	vertices.push_back({ corners[1],color,{ u1,v0 } });
+	vertices.push_back({ corners[2],color,{ u1,v1 } });
+	vertices.push_back({ corners[3],color,{ u0,v1 } });
+	int order[6] = { 0,1,2,0,2,3 };
+	for (int i = 0; i < 6; i++)
+		indices.push_back(base + order[i]);
+}
+
+/*
+ * \brief Draw a packed image at its own size, like Texture::Clear.
+ * \param id The number of the packed image.
+ * \param point The destination coordinate.
+ */
+inline void SpriteBatch::Clear(int id, SDL_Point point)
+{
+	SDL_Rect rect = atlas->GetRegion(id).rect;
+	RenderStretched(id, { point.x,point.y,rect.w,rect.h });
+}
+
+/*
+ * \brief Draw a packed image while rotating or flipping it, like Texture::RenderEx.
+ * \param id The number of the packed image.
+ * \param point The destination coordinate.
+ * \param angle An angle in degrees that indicates the rotation that will be applied to viewport, rotating it in a clockwise direction.
+ * \param center The rotating center, relative to the destination coordinate.
+ * \param flip A way in which flipping actions should be performed on the image.
+ */
+inline void SpriteBatch::RenderEx(int id, SDL_Point point, double angle, SDL_Point center, SDL_RendererFlip flip)
+{
+	SDL_Rect rect = atlas->GetRegion(id).rect;
+	double radian = angle * 3.14159265358979323846 / 180;
+	double c = cos(radian), s = sin(radian);
+	double cx = point.x + center.x, cy = point.y + center.y;
+	double x[4] = { (double)point.x,(double)point.x + rect.w,(double)point.x + rect.w,(double)point.x };
+	double y[4] = { (double)point.y,(double)point.y,(double)point.y + rect.h,(double)point.y + rect.h };
+	SDL_FPoint corners[4];
+	for (int i = 0; i < 4; i++)
+	{
+		double dx = x[i] - cx, dy = y[i] - cy;
+		corners[i] = { (float)(cx + dx * c - dy * s),(float)(cy + dx * s + dy * c) };
+	}
+	Quad(id, corners, flip);
+}
+
+/*
+ * \brief Draw a stretched packed image, like Texture::RenderStretched.
+ * \param id The number of the packed image.
+ * \param viewport The destination coordinate and size.
+ */
+inline void SpriteBatch::RenderStretched(int id, SDL_Rect viewport)
+{
+	float l = (float)viewport.x, t = (float)viewport.y;
+	float r = (float)(viewport.x + viewport.w), b = (float)(viewport.y + viewport.h);
+	SDL_FPoint corners[4] = { { l,t },{ r,t },{ r,b },{ l,b } };
+	Quad(id, corners, SDL_FLIP_NONE);
+}
+
+/*
+ * \brief Submit all collected sprites to the renderer.
+ * \return The number of draw calls issued during the frame.
+ */
+inline int SpriteBatch::End()
+{
+	Flush();
+	page = -1;
+	return calls;
+}
+
+/*
+ * \brief Get the number of draw calls issued since Begin().
+ * \return The number of draw calls.
+ */
+inline int SpriteBatch::GetDrawCalls()
+{
+	return calls;
+}
+
+/*
+ * \brief Deallocate the buffers of the sprite batch.
+ */
+inline void SpriteBatch::free()
+{
+	std::vector<SDL_Vertex>().swap(vertices);
+	std::vector<int>().swap(indices);
+	rend = NULL;
+	atlas = NULL;
+	page = -1;
+	calls = 0;
+}
+
+
+#endif // !spritebatch_h_
\ No newline at end of file
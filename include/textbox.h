@@ -0,0 +1,518 @@
+#ifndef textbox_h_
+#define textbox_h_
+
+#include <limits.h>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <SDL.h>
+#include <font.h>
+#include <spritebatch.h>
+#include <dirty.h>
+#include <renderqueue.h>
+#include <error.h>
+
+//Text box wrapper class
+class TextBox
+{
+private:
+	//A line of text, wrapped into rows starting at the byte offsets.
+	struct Line
+	{
+		std::string text;
+		std::vector<int> starts;
+	};
+	SDL_Renderer* rend;
+	GlyphCache glyphs;
+	SpriteBatch batch;
+	//The pane keeping the rendered rows, so that unchanged rows are never drawn again.
+	SDL_Texture* target;
+	int width, height;
+	SDL_Color color;
+	std::vector<Line> lines;
+	//Fenwick tree of the numbers of rows of lines, so that rows and lines are found in logarithmic time.
+	std::vector<int> tree;
+	int scroll;
+	//The rows to be drawn again, from the first to before the last.
+	int StaleFirst, StaleLast;
+	SDL_Rect shown;
+	void Wrap(Line& line);
+	void Build();
+	void Push(int rows);
+	void Add(int index, int delta);
+	int RowOf(int index);
+	int LineAt(int row);
+	void Stale(int first, int last);
+	void Refresh();
+public:
+	TextBox();
+	~TextBox();
+	bool Init(SDL_Renderer* renderer, const char* file, int size, int w, int h);
+	void SetColor(SDL_Color color);
+	void SetText(std::string_view text);
+	void SetLine(int index, std::string_view text);
+	void Append(std::string_view text);
+	int GetLineCount();
+	int GetRowCount();
+	int GetVisibleRows();
+	void ScrollTo(int row);
+	void ScrollToEnd();
+	int GetScroll();
+	void Render(SDL_Point point);
+	void free();
+};
+
+/*
+ * \brief Create an empty text box.
+ */
+inline TextBox::TextBox()
+{
+	rend = NULL;
+	target = NULL;
+	width = 0;
+	height = 0;
+	color = { 0,0,0,255 };
+	scroll = 0;
+	StaleFirst = INT_MAX;
+	StaleLast = 0;
+	shown = { 0,0,0,0 };
+}
+
+/*
+ * \brief Deallocate the text box.
+ */
+inline TextBox::~TextBox()
+{
+	free();
+}
+
+/*
+ * \brief Create a text box with a single empty line.
+ * \param renderer The renderer which should draw the text box.
+ * \param file The path of the font, which is opened through the shared font pool.
+ * \param size The size of text.
+ * \param w The width of the pane, at which lines are wrapped.
+ * \param h The height of the pane.
+ * \return 1 if succeeded, or 0 if failed.
+ */
+inline bool TextBox::Init(SDL_Renderer* renderer, const char* file, int size, int w, int h)
+{
+	free();
+	if (!glyphs.Init(renderer, file, size))
+		return 0;
+	target = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, w, h);
+	if (target == NULL)
+	{
+		SDL_ReportError("SDL_CreateTexture");
+		glyphs.free();
+		return 0;
+	}
+	SDL_SetTextureBlendMode(target, SDL_BLENDMODE_BLEND);
+	rend = renderer;
+	width = w;
+	height = h;
+	lines.resize(1);
+	Wrap(lines[0]);
+	Build();
+	Stale(0, GetVisibleRows());
+	return 1;
+}
+
+/*
+ * \brief Set the color of text, which redraws all visible rows.
+ * \param color The color of text.
+ */
+inline void TextBox::SetColor(SDL_Color color)
+{
+	this->color = color;
+	Stale(scroll, scroll + GetVisibleRows());
+}
+
+/*
+ * \brief Break a line into rows no wider than the pane, after the last space of a row where possible.
+ */
+inline void TextBox::Wrap(Line& line)
+{
+	line.starts.assign(1, 0);
+	const char* text = line.text.data();
+	int length = (int)line.text.size();
+	int x = 0;
+	//The offset after the last space in the row, and the pen position there.
+	int space = -1, SpaceX = 0;
+	Uint32 previous = 0;
+	for (int i = 0; i < length;)
+	{
+		int at = i;
+		Uint32 code = DecodeUTF8(text, length, i);
+		int advance = glyphs.Advance(code, previous);
+		if (x + advance > width && at > line.starts.back())
+		{
+			if (space > line.starts.back())
+			{
+				line.starts.push_back(space);
+				x -= SpaceX;
+			}
+			else
+			{
+				line.starts.push_back(at);
+				x = 0;
+				advance = glyphs.Advance(code, 0);
+			}
+			space = -1;
+		}
+		x += advance;
+		if (code == ' ')
+		{
+			space = i;
+			SpaceX = x;
+		}
+		previous = code;
+	}
+}
+
+/*
+ * \brief Build the Fenwick tree from the rows of all lines.
+ */
+inline void TextBox::Build()
+{
+	int n = (int)lines.size();
+	tree.assign(n + 1, 0);
+	for (int i = 1; i <= n; i++)
+	{
+		tree[i] += (int)lines[i - 1].starts.size();
+		int parent = i + (i & -i);
+		if (parent <= n)
+			tree[parent] += tree[i];
+	}
+}
+
+/*
+ * \brief Add the rows of a line appended to the end into the Fenwick tree.
+ */
+inline void TextBox::Push(int rows)
+{
+	int i = (int)tree.size();
+	//The new node covers the lines after i - (i & -i).
+	tree.push_back(rows + RowOf(i - 1) - RowOf(i - (i & -i)));
+}
+
+/*
+ * \brief Change the number of rows of a line in the Fenwick tree.
+ */
+inline void TextBox::Add(int index, int delta)
+{
+	for (int i = index + 1; i < tree.size(); i += i & -i)
+		tree[i] += delta;
+}
+
+/*
+ * \brief Get the first row of a line.
+ * \param index The number of the line, or the number of lines for the number of all rows.
+ */
+inline int TextBox::RowOf(int index)
+{
+	int row = 0;
+	for (int i = index; i > 0; i -= i & -i)
+		row += tree[i];
+	return row;
+}
+
+/*
+ * \brief Get the line containing a row.
+ */
+inline int TextBox::LineAt(int row)
+{
+	int n = (int)tree.size() - 1;
+	int step = 1;
+	while (step * 2 <= n)
+		step *= 2;
+	//Descend the tree, skipping whole nodes which end at or before the row.
+	int index = 0;
+	for (; step > 0; step /= 2)
+		if (index + step <= n && tree[index + step] <= row)
+		{
+			index += step;
+			row -= tree[index];
+		}
+	return index < n ? index : n - 1;
+}
+
+/*
+ * \brief Mark rows to be drawn again.
+ */
+inline void TextBox::Stale(int first, int last)
+{
+	if (first < StaleFirst)
+		StaleFirst = first;
+	if (last > StaleLast)
+		StaleLast = last;
+	DirtyRegion* dirty = GetDirtyRegion(rend);
+	if (dirty != NULL)
+		dirty->Mark(shown);
+}
+
+/*
+ * \brief Replace all text. Only the lines which differ are laid out and drawn again, so it suits a TextInput after Changed().
+ * \param text The UTF-8 text, in which '\n' starts a new line.
+ */
+inline void TextBox::SetText(std::string_view text)
+{
+	std::vector<std::string_view> pieces;
+	for (size_t from = 0;;)
+	{
+		size_t to = text.find('\n', from);
+		pieces.push_back(text.substr(from, to == std::string_view::npos ? std::string_view::npos : to - from));
+		if (to == std::string_view::npos)
+			break;
+		from = to + 1;
+	}
+	int before = (int)lines.size(), after = (int)pieces.size();
+	//Skip the lines which are the same at the beginning and at the end.
+	int same = 0;
+	while (same < before && same < after && lines[same].text == pieces[same])
+		same++;
+	int tail = 0;
+	while (tail < before - same && tail < after - same && lines[before - 1 - tail].text == pieces[after - 1 - tail])
+		tail++;
+	int first = RowOf(same);
+	if (before == after)
+	{
+		bool shifted = false;
+		for (int i = same; i < after - tail; i++)
+		{
+			int rows = (int)lines[i].starts.size();
+			lines[i].text.assign(pieces[i].data(), pieces[i].size());
+			Wrap(lines[i]);
+			if (lines[i].starts.size() != rows)
+			{
+				Add(i, (int)lines[i].starts.size() - rows);
+				shifted = true;
+			}
+		}
+		//Rows after a line which grew or shrank move, so they are drawn again.
+		Stale(first, shifted ? INT_MAX : RowOf(after - tail));
+		if (shifted)
+			ScrollTo(scroll);
+		return;
+	}
+	lines.erase(lines.begin() + same, lines.begin() + before - tail);
+	lines.insert(lines.begin() + same, after - tail - same, Line());
+	for (int i = same; i < after - tail; i++)
+	{
+		lines[i].text.assign(pieces[i].data(), pieces[i].size());
+		Wrap(lines[i]);
+	}
+	Build();
+	Stale(first, INT_MAX);
+	ScrollTo(scroll);
+}
+
+/*
+ * \brief Replace a line.
+ * \param index The number of the line.
+ * \param text The UTF-8 text without '\n'.
+ */
+inline void TextBox::SetLine(int index, std::string_view text)
+{
+	if (index < 0 || index >= lines.size())
+		return;
+	int rows = (int)lines[index].starts.size();
+	lines[index].text.assign(text.data(), text.size());
+	Wrap(lines[index]);
+	int delta = (int)lines[index].starts.size() - rows;
+	Add(index, delta);
+	Stale(RowOf(index), delta != 0 ? INT_MAX : RowOf(index + 1));
+	if (delta < 0)
+		ScrollTo(scroll);
+}
+
+/*
+ * \brief Append text to the last line, such as for a log or chat pane. Only the last line and the new lines are laid out.
+ * \param text The UTF-8 text, in which '\n' starts a new line.
+ */
+inline void TextBox::Append(std::string_view text)
+{
+	int last = (int)lines.size() - 1;
+	int first = RowOf(last);
+	size_t to = text.find('\n');
+	lines[last].text.append(text.data(), to == std::string_view::npos ? text.size() : to);
+	int rows = (int)lines[last].starts.size();
+	Wrap(lines[last]);
+	Add(last, (int)lines[last].starts.size() - rows);
+	while (to != std::string_view::npos)
+	{
+		size_t from = to + 1;
+		to = text.find('\n', from);
+		lines.push_back(Line());
+		lines.back().text.assign(text.data() + from, (to == std::string_view::npos ? text.size() : to) - from);
+		Wrap(lines.back());
+		Push((int)lines.back().starts.size());
+	}
+	Stale(first, INT_MAX);
+}
+
+/*
+ * \brief Get the number of lines.
+ * \return The number of lines.
+ */
+inline int TextBox::GetLineCount()
+{
+	return (int)lines.size();
+}
+
+/*
+ * \brief Get the number of rows after wrapping.
+ * \return The number of rows.
+ */
+inline int TextBox::GetRowCount()
+{
+	return RowOf((int)lines.size());
+}
+
+/*
+ * \brief Get the number of rows shown in the pane, including a partly shown one.
+ * \return The number of rows.
+ */
+inline int TextBox::GetVisibleRows()
+{
+	int lineskip = glyphs.GetLineSkip();
+	return lineskip > 0 ? (height + lineskip - 1) / lineskip : 0;
+}
+
+/*
+ * \brief Scroll the pane, which draws all visible rows again.
+ * \param row The first row shown, which is kept inside the text.
+ */
+inline void TextBox::ScrollTo(int row)
+{
+	int last = GetRowCount() - height / (glyphs.GetLineSkip() > 0 ? glyphs.GetLineSkip() : 1);
+	if (row > last)
+		row = last;
+	if (row < 0)
+		row = 0;
+	if (row != scroll)
+	{
+		scroll = row;
+		Stale(scroll, scroll + GetVisibleRows());
+	}
+}
+
+/*
+ * \brief Scroll the pane to show the last row.
+ */
+inline void TextBox::ScrollToEnd()
+{
+	ScrollTo(INT_MAX);
+}
+
+/*
+ * \brief Get the first row shown.
+ * \return The number of the row.
+ */
+inline int TextBox::GetScroll()
+{
+	return scroll;
+}
+
+/*
+ * \brief Draw the stale visible rows into the pane.
+ */
+inline void TextBox::Refresh()
+{
+	int lineskip = glyphs.GetLineSkip();
+	int first = StaleFirst > scroll ? StaleFirst : scroll;
+	int last = StaleLast < scroll + GetVisibleRows() ? StaleLast : scroll + GetVisibleRows();
+	StaleFirst = INT_MAX;
+	StaleLast = 0;
+	if (first >= last)
+		return;
+	//Keep the state of the renderer, so that the text box can be drawn anywhere in a frame.
+	SDL_Texture* previous = SDL_GetRenderTarget(rend);
+	SDL_Rect clip;
+	bool clipped = SDL_RenderIsClipEnabled(rend);
+	SDL_RenderGetClipRect(rend, &clip);
+	Uint8 r, g, b, a;
+	SDL_GetRenderDrawColor(rend, &r, &g, &b, &a);
+	SDL_BlendMode blend;
+	SDL_GetRenderDrawBlendMode(rend, &blend);
+	//Queued copies go to the current target, and may show the rows about to change.
+	FlushRenderQueue(rend);
+	SDL_SetRenderTarget(rend, target);
+	//Clear the rows to transparent.
+	SDL_Rect band = { 0,(first - scroll) * lineskip,width,(last - first) * lineskip };
+	SDL_RenderSetClipRect(rend, &band);
+	SDL_SetRenderDrawBlendMode(rend, SDL_BLENDMODE_NONE);
+	SDL_SetRenderDrawColor(rend, 0, 0, 0, 0);
+	SDL_RenderFillRect(rend, &band);
+	//Draw the rows.
+	batch.Begin(rend, glyphs.GetAtlas());
+	int index = LineAt(first);
+	int row = first - RowOf(index);
+	for (int i = first; i < last && index < lines.size(); i++)
+	{
+		const Line& line = lines[index];
+		int from = line.starts[row];
+		int to = row + 1 < line.starts.size() ? line.starts[row + 1] : (int)line.text.size();
+		glyphs.Draw(batch, std::string_view(line.text).substr(from, to - from), { 0,(i - scroll) * lineskip }, color);
+		if (++row == line.starts.size())
+		{
+			index++;
+			row = 0;
+		}
+	}
+	batch.End();
+	SDL_SetRenderTarget(rend, previous);
+	SDL_RenderSetClipRect(rend, clipped ? &clip : NULL);
+	SDL_SetRenderDrawBlendMode(rend, blend);
+	SDL_SetRenderDrawColor(rend, r, g, b, a);
+}
+
+/*
+ * \brief Show the text box on the renderer, drawing only the rows which changed since the last showing.
+ * \param point The destination coordinate of the top left corner.
+ */
+inline void TextBox::Render(SDL_Point point)
+{
+	if (target == NULL)
+		return;
+	Refresh();
+	shown = { point.x,point.y,width,height };
+	DirtyRegion* dirty = GetDirtyRegion(rend);
+	if (dirty != NULL && !dirty->Track(this, shown))
+		return;
+	RenderQueue* queue = GetRenderQueue(rend);
+	if (queue != NULL)
+		queue->Copy(target, NULL, &shown);
+	else
+		SDL_RenderCopy(rend, target, NULL, &shown);
+}
+
+/*
+ * \brief Deallocate the text box.
+ */
+inline void TextBox::free()
+{
+	if (target != NULL)
+	{
+		DirtyRegion* dirty = GetDirtyRegion(rend);
+		if (dirty != NULL)
+			dirty->Forget(this);
+		FlushRenderQueue(rend);
+		SDL_DestroyTexture(target);
+	}
+	target = NULL;
+	batch.free();
+	glyphs.free();
+	std::vector<Line>().swap(lines);
+	std::vector<int>().swap(tree);
+	rend = NULL;
+	width = 0;
+	height = 0;
+	scroll = 0;
+	StaleFirst = INT_MAX;
+	StaleLast = 0;
+	shown = { 0,0,0,0 };
+}
+
+
+#endif // !textbox_h_
\ No newline at end of file
@@ -1,20 +1,39 @@
 #ifndef textinput_h_
 #define textinput_h_
 
+#include <string.h>
 #include <string>
+#include <string_view>
 #include <SDL.h>
+#include <gapbuffer.h>
 
 //Importable text wrapper class
 class TextInput
 {
 private:
+	GapBuffer text;
+	//Byte offsets of the cursor and the other end of the selection, which equal when nothing is selected.
+	int cursor;
+	int anchor;
+	//The modifiers held at the last key event, since text input events don't carry them.
+	Uint16 modifiers;
 	bool changetext;
+	int Previous(int position);
+	int Next(int position);
+	void EraseSelection();
+	void MoveCursor(int position, bool select);
 public:
-	std::string text;
 	TextInput();
 	~TextInput();
-	void HandleEvent(SDL_Event event);
+	void HandleEvent(const SDL_Event& event);
+	void Insert(const char* text, int length);
 	std::string GetContent();
+	std::string_view View();
+	std::string GetSelected();
+	int GetCursor();
+	void SetCursor(int position);
+	void Select(int first, int last);
+	bool HasSelection();
 	bool Changed();
 	void ResetChange();
 	int Length();
@@ -23,54 +42,156 @@ public:
 /*
  * \brief Create an importable text.
  */
-TextInput::TextInput()
+inline TextInput::TextInput()
 {
-	text = " ";
+	text.Insert(0, " ", 1);
+	cursor = 1;
+	anchor = 1;
+	modifiers = KMOD_NONE;
 	changetext = false;
 }
 
 /*
  * \brief Deallocate an importable text.
  */
-TextInput::~TextInput()
+inline TextInput::~TextInput()
 {
-	text = " ";
+	text.free();
+	cursor = 0;
+	anchor = 0;
+	modifiers = KMOD_NONE;
 	changetext = false;
 }
 
+/*
+ * \brief Find the start of the UTF-8 character before a position.
+ */
+inline int TextInput::Previous(int position)
+{
+	if (position <= 0)
+		return 0;
+	position--;
+	//Skip continuation bytes, so that multi-byte characters are never cut in half.
+	while (position > 0 && ((Uint8)text.At(position) & 0xC0) == 0x80)
+		position--;
+	return position;
+}
+
+/*
+ * \brief Find the start of the UTF-8 character after a position.
+ */
+inline int TextInput::Next(int position)
+{
+	int length = text.Length();
+	if (position >= length)
+		return length;
+	position++;
+	while (position < length && ((Uint8)text.At(position) & 0xC0) == 0x80)
+		position++;
+	return position;
+}
+
+/*
+ * \brief Erase the selected text, leaving the cursor where it started.
+ */
+inline void TextInput::EraseSelection()
+{
+	int first = cursor < anchor ? cursor : anchor;
+	int last = cursor < anchor ? anchor : cursor;
+	text.Erase(first, last - first);
+	cursor = first;
+	anchor = first;
+	if (last > first)
+		changetext = true;
+}
+
+/*
+ * \brief Move the cursor, extending the selection or dropping it.
+ */
+inline void TextInput::MoveCursor(int position, bool select)
+{
+	cursor = position;
+	if (!select)
+		anchor = position;
+}
+
 /*
  * \brief Change the content of text according to events.
- * \param event If not NULL, the next event is removed from the queue and stored in that area.
+ * \param event The event to be handled, such as one dispatched by an EventHub.
  */
-void TextInput::HandleEvent(SDL_Event event)
+inline void TextInput::HandleEvent(const SDL_Event& event)
 {
+	//Key events carry the modifiers held when they happened, which saves asking SDL on every keystroke.
+	if (event.type == SDL_KEYDOWN || event.type == SDL_KEYUP)
+		modifiers = event.key.keysym.mod;
+	bool ctrl = (modifiers & KMOD_CTRL) != 0;
+	bool shift = (modifiers & KMOD_SHIFT) != 0;
 	switch (event.type)
 	{
 		case SDL_KEYDOWN:
-			//Handle deleting.
-			if (event.key.keysym.sym == SDLK_BACKSPACE && text.length() > 0)
-			{
-				text.pop_back();
-				changetext = true;
-			}
-			//Handle copying.
-			else if (event.key.keysym.sym == SDLK_c && (SDL_GetModState() & KMOD_CTRL))
-				SDL_SetClipboardText(text.c_str());
-			//Handle pasting.
-			else if (event.key.keysym.sym == SDLK_v && (SDL_GetModState() & KMOD_CTRL))
+			switch (event.key.keysym.sym)
 			{
-				text += SDL_GetClipboardText();
-				changetext = true;
+				//Handle deleting.
+				case SDLK_BACKSPACE:
+					if (!HasSelection())
+						anchor = Previous(cursor);
+					EraseSelection();
+					break;
+				case SDLK_DELETE:
+					if (!HasSelection())
+						anchor = Next(cursor);
+					EraseSelection();
+					break;
+				//Handle moving the cursor.
+				case SDLK_LEFT:
+					MoveCursor(HasSelection() && !shift ? (cursor < anchor ? cursor : anchor) : Previous(cursor), shift);
+					break;
+				case SDLK_RIGHT:
+					MoveCursor(HasSelection() && !shift ? (cursor > anchor ? cursor : anchor) : Next(cursor), shift);
+					break;
+				case SDLK_HOME:
+					MoveCursor(0, shift);
+					break;
+				case SDLK_END:
+					MoveCursor(text.Length(), shift);
+					break;
+				//Handle selecting all.
+				case SDLK_a:
+					if (ctrl)
+						Select(0, text.Length());
+					break;
+				//Handle copying, which copies all text if nothing is selected.
+				case SDLK_c:
+					if (ctrl)
+						SDL_SetClipboardText(HasSelection() ? GetSelected().c_str() : GetContent().c_str());
+					break;
+				//Handle cutting.
+				case SDLK_x:
+					if (ctrl && HasSelection())
+					{
+						SDL_SetClipboardText(GetSelected().c_str());
+						EraseSelection();
+					}
+					break;
+				//Handle pasting.
+				case SDLK_v:
+					if (ctrl)
+					{
+						//The clipboard text is allocated by SDL.
+						char* clipboard = SDL_GetClipboardText();
+						Insert(clipboard, (int)strlen(clipboard));
+						SDL_free(clipboard);
+					}
+					break;
+				default:
+					break;
 			}
 			break;
 
 		case SDL_TEXTINPUT:
 			//Handle characters input.
-			if (!((SDL_GetModState() & KMOD_CTRL) && (event.text.text[0] == 'c' || event.text.text[0] == 'C' || event.text.text[0] == 'v' || event.text.text[0] == 'V')))
-			{
-				text += event.text.text;
-				changetext = true;
-			}
+			if (!(ctrl && (event.text.text[0] == 'c' || event.text.text[0] == 'C' || event.text.text[0] == 'v' || event.text.text[0] == 'V' || event.text.text[0] == 'x' || event.text.text[0] == 'X' || event.text.text[0] == 'a' || event.text.text[0] == 'A')))
+				Insert(event.text.text, (int)strlen(event.text.text));
 			break;
 		default:
 			break;
@@ -78,12 +199,94 @@ void TextInput::HandleEvent(SDL_Event event)
 }
 
 /*
- * \brief Get the content of text.
+ * \brief Insert text at the cursor, replacing the selection.
+ * \param text The UTF-8 text.
+ * \param length The number of bytes.
+ */
+inline void TextInput::Insert(const char* text, int length)
+{
+	EraseSelection();
+	if (length <= 0)
+		return;
+	this->text.Insert(cursor, text, length);
+	cursor += length;
+	anchor = cursor;
+	changetext = true;
+}
+
+/*
+ * \brief Get a copy of the content of text.
  * \return The content of text.
  */
 inline std::string TextInput::GetContent()
 {
-	return text;
+	return std::string(text.View());
+}
+
+/*
+ * \brief View the content of text without copying it. The view stays valid until the text changes.
+ * \return The view of the content.
+ */
+inline std::string_view TextInput::View()
+{
+	return text.View();
+}
+
+/*
+ * \brief Get a copy of the selected text.
+ * \return The selected text, or an empty string if nothing is selected.
+ */
+inline std::string TextInput::GetSelected()
+{
+	int first = cursor < anchor ? cursor : anchor;
+	int last = cursor < anchor ? anchor : cursor;
+	return text.Substring(first, last - first);
+}
+
+/*
+ * \brief Get the position of the cursor.
+ * \return The byte offset of the cursor.
+ */
+inline int TextInput::GetCursor()
+{
+	return cursor;
+}
+
+/*
+ * \brief Move the cursor, dropping the selection.
+ * \param position The byte offset, which is moved back to the start of a UTF-8 character.
+ */
+inline void TextInput::SetCursor(int position)
+{
+	Select(position, position);
+}
+
+/*
+ * \brief Select a part of text, leaving the cursor at the last end.
+ * \param first The byte offset of one end of the selection.
+ * \param last The byte offset of the other end, where the cursor goes.
+ */
+inline void TextInput::Select(int first, int last)
+{
+	int length = text.Length();
+	first = first < 0 ? 0 : (first > length ? length : first);
+	last = last < 0 ? 0 : (last > length ? length : last);
+	//Keep both ends at the starts of characters.
+	while (first > 0 && first < length && ((Uint8)text.At(first) & 0xC0) == 0x80)
+		first--;
+	while (last > 0 && last < length && ((Uint8)text.At(last) & 0xC0) == 0x80)
+		last--;
+	anchor = first;
+	cursor = last;
+}
+
+/*
+ * \brief Determine if any text is selected.
+ * \return 1 if selected, or 0 if not.
+ */
+inline bool TextInput::HasSelection()
+{
+	return cursor != anchor;
 }
 
 /*
@@ -105,11 +308,11 @@ inline void TextInput::ResetChange()
 
 /*
  * \brief Get the length of text.
- * \return The length of text.
+ * \return The length of text in bytes.
  */
 inline int TextInput::Length()
 {
-	return (int)text.length();
+	return text.Length();
 }
 
 
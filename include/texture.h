@@ -1,10 +1,19 @@
 #ifndef texture_h_
 #define texture_h_
 
+#include <math.h>
+#include <memory>
 #include <vector>
 #include <SDL.h>
 #include <SDL_image.h>
 #include <collision.h>
+#include <spatialhash.h>
+#include <aabbtree.h>
+#include <font.h>
+#include <dirty.h>
+#include <renderqueue.h>
+#include <profiler.h>
+#include <jobs.h>
 #include <error.h>
 
 //Texture wrapper class
@@ -14,12 +23,21 @@ protected:
 	SDL_Renderer* rend;
 	SDL_Texture* texture;
 	int w, h;
+	//The texture lending its pixels, which is kept alive instead of being destroyed.
+	std::shared_ptr<Texture> owner;
+	bool Track(SDL_Rect bound);
+	void Untrack();
 public:
 	Texture();
+	Texture(const Texture&) = delete;
+	Texture(Texture&& other);
 	~Texture();
+	Texture& operator=(const Texture&) = delete;
+	Texture& operator=(Texture&& other);
 	void CreateFromImage(SDL_Renderer* renderer, const char* file);
 	void CreateFromImage(SDL_Renderer* renderer, const char* file, SDL_Color color);
 	void CreateFromText(SDL_Renderer* renderer, std::string message, const char* file, SDL_Color color, int size);
+	void CreateFromSurface(SDL_Renderer* renderer, SDL_Surface* surface);
 	void SetColor(Uint8 r, Uint8 g, Uint8 b);
 	void SetBlend(SDL_BlendMode blendmode);
 	void SetAlpha(Uint8 alpha);
@@ -27,15 +45,19 @@ public:
 	void Clear(SDL_Point point, SDL_Rect* clip = NULL);
 	void RenderEx(SDL_Point point, double angle, SDL_Point center, SDL_RendererFlip flip, SDL_Rect* clip = NULL);
 	void RenderStretched(SDL_Rect viewport, SDL_Rect* clip = NULL);
+	void Share(std::shared_ptr<Texture> source);
+	void Invalidate();
 	int GetWidth();
 	int GetHeight();
+	SDL_Texture* GetTexture();
+	SDL_Renderer* GetRenderer();
 	void free();
 };
 
 /*
  * \brief Create an empty texture.
  */
-Texture::Texture()
+inline Texture::Texture()
 {
 	rend = NULL;
 	texture = NULL;
@@ -43,21 +65,63 @@ Texture::Texture()
 	h = 0;
 }
 
+/*
+ * \brief Take over a texture, leaving the source empty.
+ * \param other The source texture.
+ */
+inline Texture::Texture(Texture&& other)
+{
+	rend = other.rend;
+	texture = other.texture;
+	w = other.w;
+	h = other.h;
+	owner = std::move(other.owner);
+	other.Untrack();
+	other.rend = NULL;
+	other.texture = NULL;
+	other.w = 0;
+	other.h = 0;
+}
+
 /*
  * \brief Deallocate the texture.
  */
-Texture::~Texture()
+inline Texture::~Texture()
 {
 	free();
 }
 
+/*
+ * \brief Deallocate the texture, and take over another one, leaving the source empty.
+ * \param other The source texture.
+ */
+inline Texture& Texture::operator=(Texture&& other)
+{
+	if (this != &other)
+	{
+		free();
+		rend = other.rend;
+		texture = other.texture;
+		w = other.w;
+		h = other.h;
+		owner = std::move(other.owner);
+		other.Untrack();
+		other.rend = NULL;
+		other.texture = NULL;
+		other.w = 0;
+		other.h = 0;
+	}
+	return *this;
+}
+
 /*
  * \brief Load an image directly into a texture.
  * \param renderer The renderer which should copy parts of a texture.
  * \param file The path of the source image.
  */
-void Texture::CreateFromImage(SDL_Renderer* renderer, const char* file)
+inline void Texture::CreateFromImage(SDL_Renderer* renderer, const char* file)
 {
+	PROFILE_ZONE("Texture::CreateFromImage");
 	free();
 	rend = renderer;
 	//Create the texture.
@@ -75,8 +139,9 @@ void Texture::CreateFromImage(SDL_Renderer* renderer, const char* file)
  * \param file_image The path of the source image.
  * \param color The color to be made transparent.
  */
-void Texture::CreateFromImage(SDL_Renderer* renderer, const char* file, SDL_Color color)
+inline void Texture::CreateFromImage(SDL_Renderer* renderer, const char* file, SDL_Color color)
 {
+	PROFILE_ZONE("Texture::CreateFromImage");
 	free();
 	rend = renderer;
 	//Load the image into a surface.
@@ -103,27 +168,24 @@ void Texture::CreateFromImage(SDL_Renderer* renderer, const char* file, SDL_Colo
 /*
  * \brief Create a texture from a string of message.
  * \param renderer The renderer which should copy parts of a texture.
- * \param message The string of source message.
- * \param file The path of the source font.
+ * \param message The UTF-8 string of source message.
+ * \param file The path of the source font, which is kept open in the shared font pool.
  * \param color The color of text.
  * \param size The size of text.
  */
-void Texture::CreateFromText(SDL_Renderer* renderer, std::string message, const char* file, SDL_Color color, int size)
+inline void Texture::CreateFromText(SDL_Renderer* renderer, std::string message, const char* file, SDL_Color color, int size)
 {
+	PROFILE_ZONE("Texture::CreateFromText");
 	free();
 	rend = renderer;
-	//Open the file of font.
-	TTF_Font* font = TTF_OpenFont(file, size);
-	if (font == NULL)
-		SDL_ReportError("TTF_OpenFont");
-	else
+	//Get the font from the pool instead of opening the file every time.
+	TTF_Font* font = GetFontPool().Get(file, size);
+	if (font != NULL)
 	{
 		//Load the message into a surface.
-		SDL_Surface* surface = TTF_RenderText_Blended(font, message.c_str(), color);
-		//Close the file of font.
-		TTF_CloseFont(font);
+		SDL_Surface* surface = TTF_RenderUTF8_Blended(font, message.c_str(), color);
 		if (surface == NULL)
-			SDL_ReportError("TTF_RenderText");
+			TTF_ReportError("TTF_RenderUTF8");
 		else
 		{
 			//Create the texture from surface.
@@ -140,36 +202,57 @@ void Texture::CreateFromText(SDL_Renderer* renderer, std::string message, const
 	}
 }
 
+/*
+ * \brief Create a texture from a surface, such as an image decoded on another thread.
+ * \param renderer The renderer which should copy parts of a texture.
+ * \param surface The source surface, which is still owned by the caller.
+ */
+inline void Texture::CreateFromSurface(SDL_Renderer* renderer, SDL_Surface* surface)
+{
+	free();
+	rend = renderer;
+	//Create the texture from surface.
+	texture = SDL_CreateTextureFromSurface(rend, surface);
+	if (texture == NULL)
+		SDL_ReportError("SDL_CreateTextureFromSurface");
+	else
+		//Get the width and height of the texture.
+		SDL_QueryTexture(texture, NULL, NULL, &w, &h);
+}
+
 /*
  * \brief Set an additional color value used in render copy operations.
  * \param r The red color value multiplied into copy operations.
  * \param g The green color value multiplied into copy operations.
  * \param b The blue color value multiplied into copy operations.
  */
-void Texture::SetColor(Uint8 r, Uint8 g, Uint8 b)
+inline void Texture::SetColor(Uint8 r, Uint8 g, Uint8 b)
 {
 	if (SDL_SetTextureColorMod(texture, r, g, b) != 0)
 		SDL_ReportError("SDL_SetTextureColorMod");
+	Invalidate();
 }
 
 /*
  * \brief Set the blend mode of the texture.
  * \param blendmode The blend mode to use for texture blending.
  */
-void Texture::SetBlend(SDL_BlendMode blendmode)
+inline void Texture::SetBlend(SDL_BlendMode blendmode)
 {
 	if (SDL_SetTextureBlendMode(texture, blendmode) != 0)
 		SDL_ReportError("SDL_SetTextureBlendMode");
+	Invalidate();
 }
 
 /*
  * \brief Set the transparency of the texture.
  * \param alpha The alpha value multiplied into copy operations.
  */
-void Texture::SetAlpha(Uint8 alpha)
+inline void Texture::SetAlpha(Uint8 alpha)
 {
 	if (SDL_SetTextureAlphaMod(texture, alpha) != 0)
 		SDL_ReportError("SDL_SetTextureAlphaMod");
+	Invalidate();
 }
 
 /*
@@ -178,7 +261,7 @@ void Texture::SetAlpha(Uint8 alpha)
  * \param n The target column number. (X axis)
  * \return a vector containing rectangles showing the position and size of each clip.
  */
-std::vector<SDL_Rect> Texture::Cut(int m, int n)
+inline std::vector<SDL_Rect> Texture::Cut(int m, int n)
 {
 	//Get the width and height of a single clip.
 	int single_w = w / n, single_h = h / m;
@@ -205,15 +288,22 @@ std::vector<SDL_Rect> Texture::Cut(int m, int n)
  * \param point The destination coordinate to copy the texture.
  * \param clip A pointer to the portion of source texture, or NULL for the entire texture.
  */
-void Texture::Clear(SDL_Point point, SDL_Rect* clip)
+inline void Texture::Clear(SDL_Point point, SDL_Rect* clip)
 {
+	PROFILE_ZONE("Texture::Clear");
 	SDL_Rect viewport = { point.x,point.y,w,h };
 	if (clip != NULL)
 	{
 		viewport.w = clip->w;
 		viewport.h = clip->h;
 	}
-	SDL_RenderCopy(rend, texture, clip, &viewport);
+	if (!Track(viewport))
+		return;
+	RenderQueue* queue = GetRenderQueue(rend);
+	if (queue != NULL)
+		queue->Copy(texture, clip, &viewport);
+	else
+		SDL_RenderCopy(rend, texture, clip, &viewport);
 }
 
 /*
@@ -224,15 +314,29 @@ void Texture::Clear(SDL_Point point, SDL_Rect* clip)
  * \param flip A way in which flipping actions should be performed on the texture.
  * \param clip A pointer to the portion of source texture, or NULL for the entire texture.
  */
-void Texture::RenderEx(SDL_Point point, double angle, SDL_Point center, SDL_RendererFlip flip, SDL_Rect* clip)
+inline void Texture::RenderEx(SDL_Point point, double angle, SDL_Point center, SDL_RendererFlip flip, SDL_Rect* clip)
 {
+	PROFILE_ZONE("Texture::RenderEx");
 	SDL_Rect viewport = { point.x,point.y,w,h };
 	if (clip != NULL)
 	{
 		viewport.w = clip->w;
 		viewport.h = clip->h;
 	}
-	SDL_RenderCopyEx(rend, texture, clip, &viewport, angle, &center, flip);
+	//Any rotation stays inside the circle around the center through the farthest corner.
+	int dx = center.x > viewport.w - center.x ? center.x : viewport.w - center.x;
+	int dy = center.y > viewport.h - center.y ? center.y : viewport.h - center.y;
+	int radius = (int)ceil(sqrt((double)dx * dx + (double)dy * dy));
+	SDL_Rect bound = { point.x + center.x - radius,point.y + center.y - radius,radius * 2,radius * 2 };
+	if (angle == 0)
+		bound = viewport;
+	if (!Track(bound))
+		return;
+	RenderQueue* queue = GetRenderQueue(rend);
+	if (queue != NULL)
+		queue->CopyEx(texture, clip, &viewport, angle, &center, flip);
+	else
+		SDL_RenderCopyEx(rend, texture, clip, &viewport, angle, &center, flip);
 }
 
 /*
@@ -240,9 +344,68 @@ void Texture::RenderEx(SDL_Point point, double angle, SDL_Point center, SDL_Rend
  * \param viewport The destination coordinate and size to copy the texture.
  * \param clip A pointer to the portion of source texture, or NULL for the entire texture.
  */
-void Texture::RenderStretched(SDL_Rect viewport, SDL_Rect* clip)
+inline void Texture::RenderStretched(SDL_Rect viewport, SDL_Rect* clip)
+{
+	PROFILE_ZONE("Texture::RenderStretched");
+	if (!Track(viewport))
+		return;
+	RenderQueue* queue = GetRenderQueue(rend);
+	if (queue != NULL)
+		queue->Copy(texture, clip, &viewport);
+	else
+		SDL_RenderCopy(rend, texture, clip, &viewport);
+}
+
+/*
+ * \brief Show the pixels of a shared texture, such as one from a texture cache, without copying them.
+ * The source stays alive as long as this texture uses it. Color, blend and alpha settings are shared too.
+ * \param source The shared source texture.
+ */
+inline void Texture::Share(std::shared_ptr<Texture> source)
+{
+	free();
+	if (source != NULL)
+	{
+		rend = source->rend;
+		texture = source->texture;
+		w = source->w;
+		h = source->h;
+		owner = std::move(source);
+	}
+}
+
+/*
+ * \brief Record where the texture is drawn in this frame. The places where it appeared or disappeared since the last frame
+ * are redrawn in the same frame, so a texture may be drawn at several places, such as tiles cut from one sheet.
+ * Only the destination is compared, so changing the clip drawn at the same place needs Invalidate().
+ * \param bound The screen area covered by the drawing.
+ * \return 1 if the drawing shows in the rect being redrawn, or 0 if it can be skipped.
+ */
+inline bool Texture::Track(SDL_Rect bound)
+{
+	DirtyRegion* dirty = GetDirtyRegion(rend);
+	return dirty == NULL || dirty->Track(this, bound);
+}
+
+/*
+ * \brief Mark every place where the texture was drawn, and stop tracking them, before it is destroyed or moved away.
+ */
+inline void Texture::Untrack()
 {
-	SDL_RenderCopy(rend, texture, clip, &viewport);
+	DirtyRegion* dirty = GetDirtyRegion(rend);
+	if (dirty != NULL)
+		dirty->Forget(this);
+}
+
+/*
+ * \brief Mark every place where the texture was drawn in the last frame to be redrawn, after its pixels or settings
+ * change. Textures drawn with different clips at the same place, such as animations, call it when the clip changes.
+ */
+inline void Texture::Invalidate()
+{
+	DirtyRegion* dirty = GetDirtyRegion(rend);
+	if (dirty != NULL)
+		dirty->Invalidate(this);
 }
 
 /*
@@ -263,19 +426,44 @@ inline int Texture::GetHeight()
 	return h;
 }
 
+/*
+ * \brief Get the SDL texture, such as for drawing many copies of the texture without tracking each.
+ * \return The SDL texture, or NULL if not created.
+ */
+inline SDL_Texture* Texture::GetTexture()
+{
+	return texture;
+}
+
+/*
+ * \brief Get the renderer which copies the texture.
+ * \return The renderer, or NULL if not created.
+ */
+inline SDL_Renderer* Texture::GetRenderer()
+{
+	return rend;
+}
+
 /*
  * \brief Deallocate the texture.
  */
-void Texture::free()
+inline void Texture::free()
 {
 	if (texture != NULL)
 	{
-		SDL_DestroyTexture(texture);
+		Untrack();
+		//A shared texture is released by its owner.
+		if (owner == NULL)
+		{
+			FlushRenderQueue(rend);
+			SDL_DestroyTexture(texture);
+		}
 		texture = NULL;
 		rend = NULL;
 		w = 0;
 		h = 0;
 	}
+	owner.reset();
 }
 
 //Texture derived class
@@ -283,40 +471,100 @@ class MovableTexture:public Texture
 {
 private:
 	int x, y;
+	//The position before the last move, from which rendering is interpolated.
+	int prev_x, prev_y;
+	//The offset from the position to the screen in the last showing, such as the opposite of the camera.
+	SDL_Point offset;
 	SDL_Rect range;
 	std::vector<SDL_Rect> boxes;
 	std::vector<SDL_Point> delta;
 	int velocity_x, velocity_y;
+	SpatialHash* hash;
+	std::vector<int> handles;
 	void MoveBoxes();
+	void MarkMoved();
+	void Step(AABBTree* obstacles);
+	void StepSwept(AABBTree& obstacles);
+	void Sync();
+	void Place(SDL_Point point, SDL_Rect range, const std::vector<SDL_Rect>& boxes);
 public:
 	MovableTexture();
+	MovableTexture(MovableTexture&& other);
 	~MovableTexture();
+	MovableTexture& operator=(MovableTexture&& other);
 	void CreateFromTexture(Texture texture, SDL_Point point, SDL_Rect range, std::vector<SDL_Rect> boxes);
-	void HandleEvent(SDL_Event event);
+	void CreateFromTexture(std::shared_ptr<Texture> texture, SDL_Point point, SDL_Rect range, std::vector<SDL_Rect> boxes);
+	void Register(SpatialHash& hash);
+	void Unregister();
+	const std::vector<int>& GetHandles();
+	void HandleEvent(const SDL_Event& event);
 	void Move();
+	void Move(AABBTree& obstacles);
+	void MoveSwept(const std::vector<SDL_Rect>& obstacles);
+	void MoveSwept(AABBTree& obstacles);
+	static void MoveAll(JobSystem& jobs, const std::vector<MovableTexture*>& textures);
+	static void MoveAll(JobSystem& jobs, const std::vector<MovableTexture*>& textures, AABBTree& obstacles);
+	static void MoveSweptAll(JobSystem& jobs, const std::vector<MovableTexture*>& textures, AABBTree& obstacles);
 	void CameraFollow(SDL_Rect& Camera);
 	void Show();
 	void Show(SDL_Rect& camera);
+	void Show(double alpha);
+	void Show(SDL_Rect& camera, double alpha);
 };
 
 /*
  * \brief Create an empty movable texture.
  */
-MovableTexture::MovableTexture():Texture()
+inline MovableTexture::MovableTexture():Texture()
 {
 	x = 0;
 	y = 0;
+	prev_x = 0;
+	prev_y = 0;
+	offset = { 0,0 };
 	velocity_x = 0;
 	velocity_y = 0;
+	range = { 0,0,0,0 };
+	hash = NULL;
+}
+
+/*
+ * \brief Take over a movable texture, including its registration in a spatial hash, leaving the source empty and unregistered.
+ * \param other The source movable texture.
+ */
+inline MovableTexture::MovableTexture(MovableTexture&& other):Texture(std::move(other))
+{
+	x = other.x;
+	y = other.y;
+	prev_x = other.prev_x;
+	prev_y = other.prev_y;
+	offset = other.offset;
+	range = other.range;
+	boxes = std::move(other.boxes);
+	delta = std::move(other.delta);
+	velocity_x = other.velocity_x;
+	velocity_y = other.velocity_y;
+	//The hash knows the boxes by their handles only, so the handles move with the boxes.
+	hash = other.hash;
+	handles = std::move(other.handles);
+	other.hash = NULL;
+	other.handles.clear();
+	other.boxes.clear();
+	other.delta.clear();
+	other.velocity_x = 0;
+	other.velocity_y = 0;
 }
 
 /*
  * \brief Deallocate a movable texture.
  */
-MovableTexture::~MovableTexture()
+inline MovableTexture::~MovableTexture()
 {
+	Unregister();
 	x = 0;
 	y = 0;
+	prev_x = 0;
+	prev_y = 0;
 	range = { 0,0,0,0 };
 	std::vector<SDL_Rect>().swap(boxes);
 	std::vector<SDL_Point>().swap(delta);
@@ -324,18 +572,75 @@ MovableTexture::~MovableTexture()
 	velocity_y = 0;
 }
 
+/*
+ * \brief Deallocate a movable texture, and take over another one, including its registration in a spatial hash,
+ * leaving the source empty and unregistered.
+ * \param other The source movable texture.
+ */
+inline MovableTexture& MovableTexture::operator=(MovableTexture&& other)
+{
+	if (this != &other)
+	{
+		Unregister();
+		Texture::operator=(std::move(other));
+		x = other.x;
+		y = other.y;
+		prev_x = other.prev_x;
+		prev_y = other.prev_y;
+		offset = other.offset;
+		range = other.range;
+		boxes = std::move(other.boxes);
+		delta = std::move(other.delta);
+		velocity_x = other.velocity_x;
+		velocity_y = other.velocity_y;
+		hash = other.hash;
+		handles = std::move(other.handles);
+		other.hash = NULL;
+		other.handles.clear();
+		other.boxes.clear();
+		other.delta.clear();
+		other.velocity_x = 0;
+		other.velocity_y = 0;
+	}
+	return *this;
+}
+
 /*
  * \brief Create a movable texture.
- * \param texture The source texture.
+ * \param texture The source texture, which is moved into the movable texture. (Pass it with std::move)
+ * \param point The destination coordinate to copy the texture the first time.
+ * \param range The scope of activity of the texture.
+ * \param boxes The collision boxes of the texture.
+ */
+inline void MovableTexture::CreateFromTexture(Texture texture, SDL_Point point, SDL_Rect range, std::vector<SDL_Rect> boxes)
+{
+	Texture::operator=(std::move(texture));
+	Place(point, range, boxes);
+}
+
+/*
+ * \brief Create a movable texture sharing the pixels of another texture.
+ * \param texture The shared source texture, such as one from a texture cache.
  * \param point The destination coordinate to copy the texture the first time.
  * \param range The scope of activity of the texture.
  * \param boxes The collision boxes of the texture.
  */
-void MovableTexture::CreateFromTexture(Texture texture, SDL_Point point, SDL_Rect range, std::vector<SDL_Rect> boxes)
+inline void MovableTexture::CreateFromTexture(std::shared_ptr<Texture> texture, SDL_Point point, SDL_Rect range, std::vector<SDL_Rect> boxes)
+{
+	Share(std::move(texture));
+	Place(point, range, boxes);
+}
+
+/*
+ * \brief Save the initial position, the range and the collision boxes.
+ */
+inline void MovableTexture::Place(SDL_Point point, SDL_Rect range, const std::vector<SDL_Rect>& boxes)
 {
 	//Save the initial position.
 	x = point.x;
 	y = point.y;
+	prev_x = x;
+	prev_y = y;
 	//Save the range and the movable collision boxes.
 	this->range = range;
 	for (int i = 0; i < boxes.size(); i++)
@@ -348,7 +653,7 @@ void MovableTexture::CreateFromTexture(Texture texture, SDL_Point point, SDL_Rec
 /*
  * \brief Move the collision boxes.
  */
-void MovableTexture::MoveBoxes()
+inline void MovableTexture::MoveBoxes()
 {
 	for (int i = 0; i < boxes.size(); i++)
 	{
@@ -357,11 +662,74 @@ void MovableTexture::MoveBoxes()
 	}
 }
 
+/*
+ * \brief Mark the areas before and after a move dirty, so that the move is redrawn in the same frame.
+ */
+inline void MovableTexture::MarkMoved()
+{
+	DirtyRegion* dirty = GetDirtyRegion(rend);
+	if (dirty != NULL && (x != prev_x || y != prev_y))
+	{
+		dirty->Invalidate(this);
+		dirty->Mark({ prev_x + offset.x,prev_y + offset.y,w,h });
+		dirty->Mark({ x + offset.x,y + offset.y,w,h });
+	}
+}
+
+/*
+ * \brief Bring the spatial hash and the dirty region up to date after a move.
+ * Both are shared between textures, so batched moves do it on the calling thread afterwards.
+ */
+inline void MovableTexture::Sync()
+{
+	if (x == prev_x && y == prev_y)
+		return;
+	if (hash != NULL)
+		for (int i = 0; i < handles.size(); i++)
+			hash->Update(handles[i], boxes[i]);
+	MarkMoved();
+}
+
+/*
+ * \brief Register the collision boxes in a spatial hash, which is updated whenever the texture moves.
+ * \param hash The spatial hash used as the broad phase of collision detection.
+ */
+inline void MovableTexture::Register(SpatialHash& hash)
+{
+	Unregister();
+	this->hash = &hash;
+	for (int i = 0; i < boxes.size(); i++)
+		handles.push_back(hash.Insert(boxes[i]));
+}
+
+/*
+ * \brief Remove the collision boxes from the spatial hash.
+ */
+inline void MovableTexture::Unregister()
+{
+	if (hash != NULL)
+	{
+		for (int i = 0; i < handles.size(); i++)
+			hash->Remove(handles[i]);
+		hash = NULL;
+	}
+	handles.clear();
+}
+
+/*
+ * \brief Get the numbers of the collision boxes in the spatial hash.
+ * \return A vector containing the numbers, in the same order as the collision boxes.
+ */
+inline const std::vector<int>& MovableTexture::GetHandles()
+{
+	return handles;
+}
+
 /*
  * \brief Handle movement events.
- * \param event If not NULL, the next event is removed from the queue and stored in that area.
+ * \param event The event to be handled, such as one dispatched by an EventHub.
  */
-void MovableTexture::HandleEvent(SDL_Event event)
+inline void MovableTexture::HandleEvent(const SDL_Event& event)
 {
 	int vx = w / 10;
 	int vy = h / 10;
@@ -402,14 +770,17 @@ void MovableTexture::HandleEvent(SDL_Event event)
 }
 
 /*
- * \brief Move the texture according to its velocity.
+ * \brief Move the texture according to its velocity, touching nothing but the texture itself.
+ * \param obstacles The static collision boxes which the texture can't pass through, or NULL for none.
  */
-void MovableTexture::Move()
+inline void MovableTexture::Step(AABBTree* obstacles)
 {
+	prev_x = x;
+	prev_y = y;
 	//Move in X direction.
 	x += velocity_x;
 	MoveBoxes();
-	if (InsideCollided(boxes, range))
+	if (InsideCollided(boxes, range) || (obstacles != NULL && obstacles->OutsideCollided(boxes)))
 	{
 		x -= velocity_x;
 		MoveBoxes();
@@ -417,18 +788,161 @@ void MovableTexture::Move()
 	//Move in Y direction.
 	y += velocity_y;
 	MoveBoxes();
-	if (InsideCollided(boxes, range))
+	if (InsideCollided(boxes, range) || (obstacles != NULL && obstacles->OutsideCollided(boxes)))
 	{
 		y -= velocity_y;
 		MoveBoxes();
 	}
 }
 
+/*
+ * \brief Move the texture according to its velocity.
+ */
+inline void MovableTexture::Move()
+{
+	PROFILE_ZONE("MovableTexture::Move");
+	Step(NULL);
+	Sync();
+}
+
+/*
+ * \brief Move the texture according to its velocity, and stop in front of static obstacles.
+ * \param obstacles The static collision boxes which the texture can't pass through.
+ */
+inline void MovableTexture::Move(AABBTree& obstacles)
+{
+	PROFILE_ZONE("MovableTexture::Move");
+	Step(&obstacles);
+	Sync();
+}
+
+/*
+ * \brief Move the texture according to its velocity, right up to the nearest obstacle on the way.
+ * Unlike Move(), fast textures can't pass through thin obstacles or stop short of them.
+ * \param obstacles The collision boxes which the texture can't pass through.
+ */
+inline void MovableTexture::MoveSwept(const std::vector<SDL_Rect>& obstacles)
+{
+	PROFILE_ZONE("MovableTexture::MoveSwept");
+	prev_x = x;
+	prev_y = y;
+	//Move in X direction.
+	int dx = InsideSweptX(boxes, velocity_x, range);
+	dx = OutsideSweptX(boxes, dx, obstacles);
+	if (dx != 0)
+	{
+		x += dx;
+		MoveBoxes();
+	}
+	//Move in Y direction.
+	int dy = InsideSweptY(boxes, velocity_y, range);
+	dy = OutsideSweptY(boxes, dy, obstacles);
+	if (dy != 0)
+	{
+		y += dy;
+		MoveBoxes();
+	}
+	Sync();
+}
+
+/*
+ * \brief Move the texture right up to the nearest static obstacle on the way, touching nothing but the texture itself.
+ * \param obstacles The static collision boxes which the texture can't pass through.
+ */
+inline void MovableTexture::StepSwept(AABBTree& obstacles)
+{
+	prev_x = x;
+	prev_y = y;
+	//Move in X direction.
+	int dx = InsideSweptX(boxes, velocity_x, range);
+	dx = obstacles.OutsideSweptX(boxes, dx);
+	if (dx != 0)
+	{
+		x += dx;
+		MoveBoxes();
+	}
+	//Move in Y direction.
+	int dy = InsideSweptY(boxes, velocity_y, range);
+	dy = obstacles.OutsideSweptY(boxes, dy);
+	if (dy != 0)
+	{
+		y += dy;
+		MoveBoxes();
+	}
+}
+
+/*
+ * \brief Move the texture according to its velocity, right up to the nearest static obstacle on the way.
+ * \param obstacles The static collision boxes which the texture can't pass through.
+ */
+inline void MovableTexture::MoveSwept(AABBTree& obstacles)
+{
+	PROFILE_ZONE("MovableTexture::MoveSwept");
+	StepSwept(obstacles);
+	Sync();
+}
+
+/*
+ * \brief Move many textures according to their velocities on all threads of a job system.
+ * Each texture only collides with its range, so the order of moves doesn't matter.
+ * \param jobs The job system running the moves.
+ * \param textures The textures to be moved, each of which appears once.
+ */
+inline void MovableTexture::MoveAll(JobSystem& jobs, const std::vector<MovableTexture*>& textures)
+{
+	PROFILE_ZONE("MovableTexture::MoveAll");
+	jobs.ParallelFor((int)textures.size(), 64, [&textures](int first, int last)
+	{
+		for (int i = first; i < last; i++)
+			textures[i]->Step(NULL);
+	});
+	for (int i = 0; i < textures.size(); i++)
+		textures[i]->Sync();
+}
+
+/*
+ * \brief Move many textures according to their velocities on all threads of a job system, and stop them in front of static obstacles.
+ * The obstacles are only read while moving, so the threads share them.
+ * \param jobs The job system running the moves.
+ * \param textures The textures to be moved, each of which appears once.
+ * \param obstacles The static collision boxes which the textures can't pass through.
+ */
+inline void MovableTexture::MoveAll(JobSystem& jobs, const std::vector<MovableTexture*>& textures, AABBTree& obstacles)
+{
+	PROFILE_ZONE("MovableTexture::MoveAll");
+	jobs.ParallelFor((int)textures.size(), 64, [&textures, &obstacles](int first, int last)
+	{
+		for (int i = first; i < last; i++)
+			textures[i]->Step(&obstacles);
+	});
+	for (int i = 0; i < textures.size(); i++)
+		textures[i]->Sync();
+}
+
+/*
+ * \brief Move many textures on all threads of a job system, each right up to the nearest static obstacle on its way.
+ * The obstacles are only read while moving, so the threads share them.
+ * \param jobs The job system running the moves.
+ * \param textures The textures to be moved, each of which appears once.
+ * \param obstacles The static collision boxes which the textures can't pass through.
+ */
+inline void MovableTexture::MoveSweptAll(JobSystem& jobs, const std::vector<MovableTexture*>& textures, AABBTree& obstacles)
+{
+	PROFILE_ZONE("MovableTexture::MoveSweptAll");
+	jobs.ParallelFor((int)textures.size(), 64, [&textures, &obstacles](int first, int last)
+	{
+		for (int i = first; i < last; i++)
+			textures[i]->StepSwept(obstacles);
+	});
+	for (int i = 0; i < textures.size(); i++)
+		textures[i]->Sync();
+}
+
 /*
  * \brief Make a camera follow the moving texture, placing the texture at the center of camera.
  * \param camera The camera which should shoot the texture.
  */
-void MovableTexture::CameraFollow(SDL_Rect& camera)
+inline void MovableTexture::CameraFollow(SDL_Rect& camera)
 {
 	//Move the camera in X direction.
 	camera.x = x + w / 2 - camera.w / 2;
@@ -447,18 +961,41 @@ void MovableTexture::CameraFollow(SDL_Rect& camera)
 /*
  * \brief Show the texture on a renderer.
  */
-void MovableTexture::Show()
+inline void MovableTexture::Show()
 {
+	offset = { 0,0 };
 	Clear({ x,y });
 }
 
 /*
  * \brief Show the texture on a renderer in front of a camera.
  */
-void MovableTexture::Show(SDL_Rect& camera)
+inline void MovableTexture::Show(SDL_Rect& camera)
 {
+	offset = { -camera.x,-camera.y };
 	Clear({ x - camera.x,y - camera.y });
 }
 
+/*
+ * \brief Show the texture between its last two positions, so that motion stays smooth when ticks and frames differ.
+ * \param alpha How far from the position before the last move to the current position, such as FixedLoop::Alpha().
+ */
+inline void MovableTexture::Show(double alpha)
+{
+	offset = { 0,0 };
+	Clear({ prev_x + (int)lround((x - prev_x) * alpha),prev_y + (int)lround((y - prev_y) * alpha) });
+}
+
+/*
+ * \brief Show the texture between its last two positions in front of a camera.
+ * \param camera The camera which shoots the texture.
+ * \param alpha How far from the position before the last move to the current position, such as FixedLoop::Alpha().
+ */
+inline void MovableTexture::Show(SDL_Rect& camera, double alpha)
+{
+	offset = { -camera.x,-camera.y };
+	Clear({ prev_x + (int)lround((x - prev_x) * alpha) - camera.x,prev_y + (int)lround((y - prev_y) * alpha) - camera.y });
+}
+
 
 #endif // !texture_h_
\ No newline at end of file
@@ -0,0 +1,198 @@
+#ifndef texturecache_h_
+#define texturecache_h_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <SDL.h>
+#include <texture.h>
+
+//Texture cache wrapper class
+class TextureCache
+{
+private:
+	//Textures keyed by (path, color key), where the color key is 0 for none.
+	typedef std::pair<std::string, Uint32> Key;
+	std::map<Key, std::weak_ptr<Texture>> textures;
+	SDL_Renderer* rend;
+	Uint64 hits, misses;
+	std::shared_ptr<Texture> Find(const Key& key);
+public:
+	TextureCache();
+	~TextureCache();
+	void Init(SDL_Renderer* renderer);
+	std::shared_ptr<Texture> Load(const char* file);
+	std::shared_ptr<Texture> Load(const char* file, SDL_Color color);
+	Uint64 GetHits();
+	Uint64 GetMisses();
+	Sint64 ResidentBytes();
+	int Size();
+	void Purge();
+	void free();
+};
+
+/*
+ * \brief Create an empty cache.
+ */
+inline TextureCache::TextureCache()
+{
+	rend = NULL;
+	hits = 0;
+	misses = 0;
+}
+
+/*
+ * \brief Deallocate the cache. Textures still in use stay alive until their last user goes away.
+ */
+inline TextureCache::~TextureCache()
+{
+	free();
+}
+
+/*
+ * \brief Start caching textures for a renderer.
+ * \param renderer The renderer which should copy parts of the textures.
+ */
+inline void TextureCache::Init(SDL_Renderer* renderer)
+{
+	free();
+	rend = renderer;
+}
+
+/*
+ * \brief Find a texture which is still in use.
+ * \return The shared texture, or NULL if not cached.
+ */
+inline std::shared_ptr<Texture> TextureCache::Find(const Key& key)
+{
+	auto found = textures.find(key);
+	if (found == textures.end())
+		return NULL;
+	std::shared_ptr<Texture> texture = found->second.lock();
+	//Forget the texture if all its users have gone.
+	if (texture == NULL)
+		textures.erase(found);
+	return texture;
+}
+
+/*
+ * \brief Load an image, or share the texture of an earlier load of the same image.
+ * \param file The path of the source image.
+ * \return The shared texture, or NULL if failed.
+ */
+inline std::shared_ptr<Texture> TextureCache::Load(const char* file)
+{
+	Key key(file, 0);
+	std::shared_ptr<Texture> texture = Find(key);
+	if (texture != NULL)
+	{
+		hits++;
+		return texture;
+	}
+	misses++;
+	texture = std::make_shared<Texture>();
+	texture->CreateFromImage(rend, file);
+	if (texture->GetWidth() == 0)
+		return NULL;
+	textures[key] = texture;
+	return texture;
+}
+
+/*
+ * \brief Load an image with a transparent color, or share the texture of an earlier load of the same image and color.
+ * \param file The path of the source image.
+ * \param color The color to be made transparent.
+ * \return The shared texture, or NULL if failed.
+ */
+inline std::shared_ptr<Texture> TextureCache::Load(const char* file, SDL_Color color)
+{
+	//Set a bit above RGB, so that a black color key differs from no color key.
+	Key key(file, 0x1000000 | (color.r << 16) | (color.g << 8) | color.b);
+	std::shared_ptr<Texture> texture = Find(key);
+	if (texture != NULL)
+	{
+		hits++;
+		return texture;
+	}
+	misses++;
+	texture = std::make_shared<Texture>();
+	texture->CreateFromImage(rend, file, color);
+	if (texture->GetWidth() == 0)
+		return NULL;
+	textures[key] = texture;
+	return texture;
+}
+
+/*
+ * \brief Get the number of loads which shared a cached texture.
+ * \return The number of hits.
+ */
+inline Uint64 TextureCache::GetHits()
+{
+	return hits;
+}
+
+/*
+ * \brief Get the number of loads which had to read the image.
+ * \return The number of misses.
+ */
+inline Uint64 TextureCache::GetMisses()
+{
+	return misses;
+}
+
+/*
+ * \brief Get the memory taken by the cached textures which are still in use, assuming 4 bytes a pixel.
+ * \return The number of bytes.
+ */
+inline Sint64 TextureCache::ResidentBytes()
+{
+	Purge();
+	Sint64 bytes = 0;
+	for (auto& texture : textures)
+	{
+		std::shared_ptr<Texture> alive = texture.second.lock();
+		if (alive != NULL)
+			bytes += (Sint64)alive->GetWidth() * alive->GetHeight() * 4;
+	}
+	return bytes;
+}
+
+/*
+ * \brief Get the number of cached textures which are still in use.
+ * \return The number of textures.
+ */
+inline int TextureCache::Size()
+{
+	Purge();
+	return (int)textures.size();
+}
+
+/*
+ * \brief Forget the textures whose users have all gone.
+ */
+inline void TextureCache::Purge()
+{
+	for (auto texture = textures.begin(); texture != textures.end();)
+	{
+		if (texture->second.expired())
+			texture = textures.erase(texture);
+		else
+			texture++;
+	}
+}
+
+/*
+ * \brief Forget all textures, and reset the counters.
+ */
+inline void TextureCache::free()
+{
+	textures.clear();
+	rend = NULL;
+	hits = 0;
+	misses = 0;
+}
+
+
+#endif // !texturecache_h_
\ No newline at end of file
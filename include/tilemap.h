@@ -0,0 +1,514 @@
+#ifndef tilemap_h_
+#define tilemap_h_
+
+#include <memory>
+#include <vector>
+#include <SDL.h>
+#include <texture.h>
+#include <dirty.h>
+#include <renderqueue.h>
+#include <profiler.h>
+#include <error.h>
+
+//Tilemap wrapper class
+class Tilemap
+{
+public:
+	//The number of tiles on a side of a chunk.
+	static const int ChunkSize = 16;
+private:
+	//A render target keeping the drawing of a chunk.
+	struct Slot
+	{
+		int chunk;
+		SDL_Texture* texture;
+		//The frame in which the slot was last drawn, for evicting the least recently used slot.
+		Uint64 used;
+		bool stale;
+	};
+	SDL_Renderer* rend;
+	std::shared_ptr<Texture> tileset;
+	std::vector<SDL_Rect> clips;
+	int TileW, TileH;
+	int columns, rows;
+	int ChunkColumns, ChunkRows;
+	//Tile IDs of chunks in rows, which are only allocated once a tile is set.
+	std::vector<std::vector<Uint16>> chunks;
+	//A bit a tile in rows of words, set for solid tiles.
+	std::vector<Uint64> solid;
+	int words;
+	std::vector<Slot> slots;
+	//The slot of every chunk, or -1 if not cached.
+	std::vector<int> cached;
+	int MaxCached;
+	Uint64 frame;
+	//The camera of the last rendering.
+	SDL_Rect shown;
+	int drawn, baked;
+	SDL_Texture* Bake(int chunk);
+	bool Collided(int x0, int y0, int x1, int y1);
+public:
+	Tilemap();
+	~Tilemap();
+	bool Init(SDL_Renderer* renderer, std::shared_ptr<Texture> tileset, int m, int n, int columns, int rows, int MaxCached = 64);
+	void SetTile(int x, int y, int id);
+	int GetTile(int x, int y);
+	void SetSolid(int x, int y, bool solid);
+	bool IsSolid(int x, int y);
+	bool OutsideCollided(SDL_Rect rect);
+	bool OutsideCollided(const std::vector<SDL_Rect>& A);
+	void HandleEvent(const SDL_Event& event);
+	void Render(SDL_Rect& camera);
+	int GetColumns();
+	int GetRows();
+	int GetTileWidth();
+	int GetTileHeight();
+	int GetDrawn();
+	int GetBaked();
+	int GetCached();
+	void free();
+};
+
+/*
+ * \brief Divide rounding down, so that negative coordinates fall into the right tile.
+ */
+inline int FloorDiv(int a, int b)
+{
+	return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+/*
+ * \brief Create an empty tilemap.
+ */
+inline Tilemap::Tilemap()
+{
+	rend = NULL;
+	TileW = 0;
+	TileH = 0;
+	columns = 0;
+	rows = 0;
+	ChunkColumns = 0;
+	ChunkRows = 0;
+	words = 0;
+	MaxCached = 0;
+	frame = 0;
+	shown = { 0,0,0,0 };
+	drawn = 0;
+	baked = 0;
+}
+
+/*
+ * \brief Deallocate the tilemap.
+ */
+inline Tilemap::~Tilemap()
+{
+	free();
+}
+
+/*
+ * \brief Create a tilemap without tiles.
+ * \param renderer The renderer which should draw the tilemap.
+ * \param tileset The texture holding the images of tiles, created on the renderer.
+ * \param m The number of rows of tiles in the tileset.
+ * \param n The number of columns of tiles in the tileset. Tile IDs count along rows, as the clips of Texture::Cut.
+ * \param columns The number of columns of tiles in the map.
+ * \param rows The number of rows of tiles in the map.
+ * \param MaxCached The largest number of chunks kept in render targets, which should cover the screen.
+ * \return 1 if succeeded, or 0 if failed.
+ */
+inline bool Tilemap::Init(SDL_Renderer* renderer, std::shared_ptr<Texture> tileset, int m, int n, int columns, int rows, int MaxCached)
+{
+	free();
+	if (tileset == NULL || m <= 0 || n <= 0 || tileset->GetWidth() < n || tileset->GetHeight() < m || columns <= 0 || rows <= 0)
+	{
+		SDL_SetError("Invalid tileset or size of tilemap");
+		SDL_ReportError("Tilemap::Init");
+		return 0;
+	}
+	rend = renderer;
+	this->tileset = std::move(tileset);
+	clips = this->tileset->Cut(m, n);
+	TileW = clips[0].w;
+	TileH = clips[0].h;
+	this->columns = columns;
+	this->rows = rows;
+	ChunkColumns = (columns + ChunkSize - 1) / ChunkSize;
+	ChunkRows = (rows + ChunkSize - 1) / ChunkSize;
+	chunks.resize(ChunkColumns * ChunkRows);
+	cached.assign(ChunkColumns * ChunkRows, -1);
+	words = (columns + 63) / 64;
+	solid.assign((size_t)words * rows, 0);
+	this->MaxCached = MaxCached > 0 ? MaxCached : 1;
+	return 1;
+}
+
+/*
+ * \brief Set a tile.
+ * \param x The column of the tile.
+ * \param y The row of the tile.
+ * \param id The number of the clip of the tileset, or -1 for no tile.
+ */
+inline void Tilemap::SetTile(int x, int y, int id)
+{
+	if (x < 0 || y < 0 || x >= columns || y >= rows || id >= (int)clips.size())
+		return;
+	int chunk = y / ChunkSize * ChunkColumns + x / ChunkSize;
+	if (chunks[chunk].empty())
+	{
+		if (id < 0)
+			return;
+		chunks[chunk].assign(ChunkSize * ChunkSize, 0xFFFF);
+	}
+	Uint16& tile = chunks[chunk][y % ChunkSize * ChunkSize + x % ChunkSize];
+	Uint16 value = id < 0 ? 0xFFFF : (Uint16)id;
+	if (tile == value)
+		return;
+	tile = value;
+	//Draw the chunk again the next time it shows.
+	if (cached[chunk] >= 0)
+		slots[cached[chunk]].stale = true;
+	DirtyRegion* dirty = GetDirtyRegion(rend);
+	if (dirty != NULL)
+		dirty->Mark({ x * TileW - shown.x,y * TileH - shown.y,TileW,TileH });
+}
+
+/*
+ * \brief Get a tile.
+ * \param x The column of the tile.
+ * \param y The row of the tile.
+ * \return The number of the clip of the tileset, or -1 for no tile.
+ */
+inline int Tilemap::GetTile(int x, int y)
+{
+	if (x < 0 || y < 0 || x >= columns || y >= rows)
+		return -1;
+	const std::vector<Uint16>& tiles = chunks[y / ChunkSize * ChunkColumns + x / ChunkSize];
+	if (tiles.empty())
+		return -1;
+	Uint16 tile = tiles[y % ChunkSize * ChunkSize + x % ChunkSize];
+	return tile == 0xFFFF ? -1 : tile;
+}
+
+/*
+ * \brief Set whether a tile blocks movement.
+ * \param x The column of the tile.
+ * \param y The row of the tile.
+ * \param solid Whether the tile is solid.
+ */
+inline void Tilemap::SetSolid(int x, int y, bool solid)
+{
+	if (x < 0 || y < 0 || x >= columns || y >= rows)
+		return;
+	Uint64& word = this->solid[(size_t)y * words + x / 64];
+	if (solid)
+		word |= (Uint64)1 << (x % 64);
+	else
+		word &= ~((Uint64)1 << (x % 64));
+}
+
+/*
+ * \brief Determine if a tile blocks movement.
+ * \param x The column of the tile.
+ * \param y The row of the tile.
+ * \return 1 if solid, or 0 if not solid or outside the map.
+ */
+inline bool Tilemap::IsSolid(int x, int y)
+{
+	if (x < 0 || y < 0 || x >= columns || y >= rows)
+		return 0;
+	return (solid[(size_t)y * words + x / 64] >> (x % 64)) & 1;
+}
+
+/*
+ * \brief Determine if any solid tile lies in a span of tiles, testing 64 tiles of a row at once.
+ * \param x0 The first column.
+ * \param y0 The first row.
+ * \param x1 The last column.
+ * \param y1 The last row.
+ * \return 1 if collided, or 0 if not collided.
+ */
+inline bool Tilemap::Collided(int x0, int y0, int x1, int y1)
+{
+	if (x0 < 0)
+		x0 = 0;
+	if (y0 < 0)
+		y0 = 0;
+	if (x1 >= columns)
+		x1 = columns - 1;
+	if (y1 >= rows)
+		y1 = rows - 1;
+	if (x0 > x1 || y0 > y1)
+		return 0;
+	int first = x0 / 64, last = x1 / 64;
+	Uint64 head = ~(Uint64)0 << (x0 % 64);
+	Uint64 tail = ~(Uint64)0 >> (63 - x1 % 64);
+	for (int y = y0; y <= y1; y++)
+	{
+		const Uint64* row = &solid[(size_t)y * words];
+		for (int i = first; i <= last; i++)
+		{
+			Uint64 mask = ~(Uint64)0;
+			if (i == first)
+				mask &= head;
+			if (i == last)
+				mask &= tail;
+			if (row[i] & mask)
+				return 1;
+		}
+	}
+	return 0;
+}
+
+/*
+ * \brief Determine if a box overlaps any solid tile.
+ * \param rect The target box, in map coordinates.
+ * \return 1 if collided, or 0 if not collided.
+ */
+inline bool Tilemap::OutsideCollided(SDL_Rect rect)
+{
+	if (rect.w <= 0 || rect.h <= 0 || TileW == 0)
+		return 0;
+	return Collided(FloorDiv(rect.x, TileW), FloorDiv(rect.y, TileH), FloorDiv(rect.x + rect.w - 1, TileW), FloorDiv(rect.y + rect.h - 1, TileH));
+}
+
+/*
+ * \brief Determine if any box of a set overlaps a solid tile.
+ * \param A The target collision boxes, in map coordinates.
+ * \return 1 if collided, or 0 if not collided.
+ */
+inline bool Tilemap::OutsideCollided(const std::vector<SDL_Rect>& A)
+{
+	for (int i = 0; i < A.size(); i++)
+	{
+		if (OutsideCollided(A[i]))
+			return 1;
+	}
+	return 0;
+}
+
+/*
+ * \brief Get the render target showing a chunk, drawing the chunk into the least recently used one if needed.
+ * \param chunk The number of the chunk.
+ * \return The render target, or NULL if failed.
+ */
+inline SDL_Texture* Tilemap::Bake(int chunk)
+{
+	int index = cached[chunk];
+	if (index >= 0 && !slots[index].stale)
+	{
+		slots[index].used = frame;
+		return slots[index].texture;
+	}
+	if (index < 0)
+	{
+		if (slots.size() < MaxCached)
+		{
+			SDL_Texture* texture = SDL_CreateTexture(rend, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, ChunkSize * TileW, ChunkSize * TileH);
+			if (texture == NULL)
+			{
+				SDL_ReportError("SDL_CreateTexture");
+				return NULL;
+			}
+			SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+			slots.push_back({ -1,texture,0,true });
+			index = (int)slots.size() - 1;
+		}
+		else
+		{
+			index = 0;
+			for (int i = 1; i < slots.size(); i++)
+				if (slots[i].used < slots[index].used)
+					index = i;
+			cached[slots[index].chunk] = -1;
+		}
+		slots[index].chunk = chunk;
+		cached[chunk] = index;
+	}
+	Slot& slot = slots[index];
+	slot.used = frame;
+	slot.stale = false;
+	//Keep the state of the renderer, so that the tilemap can be drawn anywhere in a frame.
+	SDL_Texture* previous = SDL_GetRenderTarget(rend);
+	SDL_Rect clip;
+	bool clipped = SDL_RenderIsClipEnabled(rend);
+	SDL_RenderGetClipRect(rend, &clip);
+	Uint8 r, g, b, a;
+	SDL_GetRenderDrawColor(rend, &r, &g, &b, &a);
+	//Queued copies go to the current target, and may show the chunk which the slot held before.
+	FlushRenderQueue(rend);
+	SDL_SetRenderTarget(rend, slot.texture);
+	SDL_SetRenderDrawColor(rend, 0, 0, 0, 0);
+	SDL_RenderClear(rend);
+	const std::vector<Uint16>& tiles = chunks[chunk];
+	SDL_Texture* source = tileset->GetTexture();
+	for (int i = 0; i < tiles.size(); i++)
+	{
+		if (tiles[i] == 0xFFFF)
+			continue;
+		SDL_Rect viewport = { i % ChunkSize * TileW,i / ChunkSize * TileH,TileW,TileH };
+		SDL_RenderCopy(rend, source, &clips[tiles[i]], &viewport);
+	}
+	SDL_SetRenderTarget(rend, previous);
+	SDL_RenderSetClipRect(rend, clipped ? &clip : NULL);
+	SDL_SetRenderDrawColor(rend, r, g, b, a);
+	baked++;
+	return slot.texture;
+}
+
+/*
+ * \brief Draw all cached chunks again when the renderer has lost the contents of its render targets.
+ * \param event The event to be handled, such as one dispatched by an EventHub.
+ */
+inline void Tilemap::HandleEvent(const SDL_Event& event)
+{
+	if (event.type == SDL_RENDER_TARGETS_RESET || event.type == SDL_RENDER_DEVICE_RESET)
+		for (int i = 0; i < slots.size(); i++)
+			slots[i].stale = true;
+}
+
+/*
+ * \brief Show the part of the tilemap in front of a camera. Only the chunks which the camera shoots are drawn,
+ * each with a single copy of its cached render target.
+ * \param camera The camera which shoots the tilemap, in map coordinates.
+ */
+inline void Tilemap::Render(SDL_Rect& camera)
+{
+	PROFILE_ZONE("Tilemap::Render");
+	if (rend == NULL)
+		return;
+	frame++;
+	drawn = 0;
+	baked = 0;
+	//Scrolling moves everything on the screen.
+	DirtyRegion* dirty = GetDirtyRegion(rend);
+	RenderQueue* queue = GetRenderQueue(rend);
+	if (dirty != NULL && (camera.x != shown.x || camera.y != shown.y || camera.w != shown.w || camera.h != shown.h))
+		dirty->MarkAll();
+	shown = camera;
+	int ChunkW = ChunkSize * TileW, ChunkH = ChunkSize * TileH;
+	int x0 = FloorDiv(camera.x, ChunkW), x1 = FloorDiv(camera.x + camera.w - 1, ChunkW);
+	int y0 = FloorDiv(camera.y, ChunkH), y1 = FloorDiv(camera.y + camera.h - 1, ChunkH);
+	if (x0 < 0)
+		x0 = 0;
+	if (y0 < 0)
+		y0 = 0;
+	if (x1 >= ChunkColumns)
+		x1 = ChunkColumns - 1;
+	if (y1 >= ChunkRows)
+		y1 = ChunkRows - 1;
+	for (int y = y0; y <= y1; y++)
+	{
+		for (int x = x0; x <= x1; x++)
+		{
+			int chunk = y * ChunkColumns + x;
+			if (chunks[chunk].empty())
+				continue;
+			SDL_Rect viewport = { x * ChunkW - camera.x,y * ChunkH - camera.y,ChunkW,ChunkH };
+			if (dirty != NULL && !dirty->Visible(viewport))
+				continue;
+			SDL_Texture* texture = Bake(chunk);
+			if (texture == NULL)
+				continue;
+			if (queue != NULL)
+				queue->Copy(texture, NULL, &viewport);
+			else if (SDL_RenderCopy(rend, texture, NULL, &viewport) != 0)
+				SDL_ReportError("SDL_RenderCopy");
+			drawn++;
+		}
+	}
+}
+
+/*
+ * \brief Get the number of columns of tiles.
+ * \return The number of columns.
+ */
+inline int Tilemap::GetColumns()
+{
+	return columns;
+}
+
+/*
+ * \brief Get the number of rows of tiles.
+ * \return The number of rows.
+ */
+inline int Tilemap::GetRows()
+{
+	return rows;
+}
+
+/*
+ * \brief Get the width of a tile.
+ * \return The width in pixels.
+ */
+inline int Tilemap::GetTileWidth()
+{
+	return TileW;
+}
+
+/*
+ * \brief Get the height of a tile.
+ * \return The height in pixels.
+ */
+inline int Tilemap::GetTileHeight()
+{
+	return TileH;
+}
+
+/*
+ * \brief Get the number of chunks drawn by the last rendering.
+ * \return The number of chunks.
+ */
+inline int Tilemap::GetDrawn()
+{
+	return drawn;
+}
+
+/*
+ * \brief Get the number of chunks drawn into render targets by the last rendering, because they were new or changed.
+ * \return The number of chunks.
+ */
+inline int Tilemap::GetBaked()
+{
+	return baked;
+}
+
+/*
+ * \brief Get the number of chunks kept in render targets.
+ * \return The number of chunks.
+ */
+inline int Tilemap::GetCached()
+{
+	return (int)slots.size();
+}
+
+/*
+ * \brief Deallocate the tiles and the render targets.
+ */
+inline void Tilemap::free()
+{
+	if (!slots.empty())
+		FlushRenderQueue(rend);
+	for (int i = 0; i < slots.size(); i++)
+		SDL_DestroyTexture(slots[i].texture);
+	slots.clear();
+	cached.clear();
+	chunks.clear();
+	solid.clear();
+	clips.clear();
+	tileset.reset();
+	rend = NULL;
+	TileW = 0;
+	TileH = 0;
+	columns = 0;
+	rows = 0;
+	ChunkColumns = 0;
+	ChunkRows = 0;
+	words = 0;
+	frame = 0;
+	shown = { 0,0,0,0 };
+	drawn = 0;
+	baked = 0;
+}
+
+
+#endif // !tilemap_h_
\ No newline at end of file
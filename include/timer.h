@@ -10,64 +10,106 @@ class Timer
 private:
 	bool started;
 	bool paused;
+	bool precise;
+	//Two counts take the place of ticks in precise mode, measured by the performance counter.
+	Uint64 CountsPlaying;
+	Uint64 CountsNotPlaying;
 public:
 	//Two ticks only update their values when the playing state alters.
 	int TicksPlaying;
 	int TicksNotPlaying;
 	Timer();
+	Timer(bool precise);
 	~Timer();
+	void SetPrecise(bool precise);
 	void Start();
 	void Stop();
 	void Pause();
 	void Resume();
 	void Reset();
 	int GetTime();
+	Uint64 GetTimeNS();
+	double GetTimeMS();
 	bool IsStarted();
 	bool IsPaused();
+	bool IsPrecise();
 	std::string WriteTime();
 };
 
 /*
  * \brief Create a timer.
  */
-Timer::Timer()
+inline Timer::Timer()
 {
 	TicksPlaying = 0;
 	TicksNotPlaying = 0;
+	CountsPlaying = 0;
+	CountsNotPlaying = 0;
 	started = 0;
 	paused = 1;
+	precise = 0;
+}
+
+/*
+ * \brief Create a timer.
+ * \param precise Whether the timer measures nanoseconds by the performance counter instead of milliseconds.
+ */
+inline Timer::Timer(bool precise)
+{
+	TicksPlaying = 0;
+	TicksNotPlaying = 0;
+	CountsPlaying = 0;
+	CountsNotPlaying = 0;
+	started = 0;
+	paused = 1;
+	this->precise = precise;
 }
 
 /*
  * \brief Deallocate a timer.
  */
-Timer::~Timer()
+inline Timer::~Timer()
+{
+	Reset();
+}
+
+/*
+ * \brief Choose how a timer measures time. The timer is reset.
+ * \param precise Whether the timer measures nanoseconds by the performance counter instead of milliseconds.
+ */
+inline void Timer::SetPrecise(bool precise)
 {
 	Reset();
+	this->precise = precise;
 }
 
 /*
  * \brief Start a timer.
  */
-void Timer::Start()
+inline void Timer::Start()
 {
 	if (!started)
 	{
 		started = 1;
 		paused = 0;
-		TicksNotPlaying = SDL_GetTicks(); //The time before is regarded as not-playing when the timer starts.
+		if (precise)
+			CountsNotPlaying = SDL_GetPerformanceCounter();
+		else
+			TicksNotPlaying = SDL_GetTicks(); //The time before is regarded as not-playing when the timer starts.
 	}
 }
 
 /*
  * \brief Stop a timer. (Unable to resume)
  */
-void Timer::Stop()
+inline void Timer::Stop()
 {
 	if (started)
 	{
 		started = 0;
-		if (!paused)
+		if (!paused && precise)
+			CountsPlaying = SDL_GetPerformanceCounter() - CountsNotPlaying;
+		else if (!paused)
 			TicksPlaying = SDL_GetTicks() - TicksNotPlaying; //Update the time of playing when stopped.
 		paused = 1;
 	}
@@ -76,49 +118,84 @@ void Timer::Stop()
 /*
  * \brief Pause the timer. (Able to resume)
  */
-void Timer::Pause()
+inline void Timer::Pause()
 {
 	if (started && !paused)
 	{
 		paused = 1;
-		TicksPlaying = SDL_GetTicks() - TicksNotPlaying; //Update the time of playing when paused.
+		if (precise)
+			CountsPlaying = SDL_GetPerformanceCounter() - CountsNotPlaying;
+		else
+			TicksPlaying = SDL_GetTicks() - TicksNotPlaying; //Update the time of playing when paused.
 	}
 }
 
 /*
  * \brief Resume the timer,
  */
-void Timer::Resume()
+inline void Timer::Resume()
 {
 	if (started && paused)
 	{
 		paused = 0;
-		TicksNotPlaying = SDL_GetTicks() - TicksPlaying; //Update the time of not_playing when resumed.
+		if (precise)
+			CountsNotPlaying = SDL_GetPerformanceCounter() - CountsPlaying;
+		else
+			TicksNotPlaying = SDL_GetTicks() - TicksPlaying; //Update the time of not_playing when resumed.
 	}
 }
 
 /*
  * \brief Reset the timer.
  */
-void Timer::Reset()
+inline void Timer::Reset()
 {
 	started = 0;
 	paused = 1;
 	TicksPlaying = 0;
 	TicksNotPlaying = 0;
+	CountsPlaying = 0;
+	CountsNotPlaying = 0;
 }
 
 /*
  * \brief Get the current time of a timer.
  * \return the number of milliseconds recorded by the timer.
  */
-int Timer::GetTime()
+inline int Timer::GetTime()
 {
+	if (precise)
+		return (int)(GetTimeNS() / 1000000);
 	if (started && !paused)
 		return SDL_GetTicks() - TicksNotPlaying;
 	return TicksPlaying;
 }
 
+/*
+ * \brief Get the current time of a timer in nanoseconds.
+ * \return the number of nanoseconds recorded by the timer, or milliseconds times 1000000 if not precise.
+ */
+inline Uint64 Timer::GetTimeNS()
+{
+	if (!precise)
+		return (Uint64)GetTime() * 1000000;
+	Uint64 counts = CountsPlaying;
+	if (started && !paused)
+		counts = SDL_GetPerformanceCounter() - CountsNotPlaying;
+	//Convert seconds and the remainder apart, so that the product never overflows.
+	Uint64 frequency = SDL_GetPerformanceFrequency();
+	return counts / frequency * 1000000000 + counts % frequency * 1000000000 / frequency;
+}
+
+/*
+ * \brief Get the current time of a timer in milliseconds, with the fraction.
+ * \return the number of milliseconds recorded by the timer.
+ */
+inline double Timer::GetTimeMS()
+{
+	return GetTimeNS() / 1000000.0;
+}
+
 /*
  * \brief Determine if a timer is started.
  * \return 1 if started, or 0 if stopped.
@@ -140,11 +217,20 @@ inline bool Timer::IsPaused()
 		return 1;
 }
 
+/*
+ * \brief Determine if a timer measures time by the performance counter.
+ * \return 1 if precise, or 0 if not.
+ */
+inline bool Timer::IsPrecise()
+{
+	return precise;
+}
+
 /*
  * \brief Write the time in a human readable way.
  * \return A string showing the current time(s) of a timer.
  */
-std::string Timer::WriteTime()
+inline std::string Timer::WriteTime()
 {
 	std::string string_time;
 	int value_time = GetTime() / 1000;
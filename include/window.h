@@ -1,7 +1,11 @@
 #ifndef window_h_
 #define window_h_
 
+#include <functional>
 #include <SDL.h>
+#include <dirty.h>
+#include <renderqueue.h>
+#include <profiler.h>
 #include <error.h>
 
 //Window wrapper class
@@ -9,6 +13,12 @@ class Window
 {
 private:
 	SDL_Window* window;
+	//The surface drawn by the software renderer of an offscreen window.
+	SDL_Surface* surface;
+	//The persistent frame which only dirty rects are redrawn into.
+	SDL_Texture* target;
+	DirtyRegion dirty;
+	bool CreateTarget();
 	int WindowID;
 	int w, h;
 	bool MouseFocus, KeyboardFocus;
@@ -16,8 +26,15 @@ private:
 public:
 	SDL_Renderer* rend;
 	Window();
-	bool Init(const char* title, int x, int y, int w, int h, Uint32 flags);
-	void HandleEvent(SDL_Event event);
+	bool Init(const char* title, int x, int y, int w, int h, Uint32 flags, Uint32 RendererFlags = SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+	bool InitOffscreen(int w, int h);
+	bool SetVSync(bool vsync);
+	SDL_Surface* ReadPixels();
+	bool SaveBMP(const char* file);
+	bool EnableDirty(bool enable, int MaxRects = 8);
+	bool Redraw(const std::function<void()>& draw);
+	DirtyRegion& GetDirty();
+	void HandleEvent(const SDL_Event& event);
 	void Focus();
 	void Clear();
 	void Present();
@@ -27,15 +44,20 @@ public:
 	bool HasKeyboardFocus();
 	bool IsShown();
 	bool IsMinimized();
+	bool IsOffscreen();
+	Uint32 GetID();
+	SDL_Renderer* GetRenderer();
 	void free();
 };
 
 /*
  * \brief Create an empty window.
  */
-Window::Window()
+inline Window::Window()
 {
 	window = NULL;
+	surface = NULL;
+	target = NULL;
 	WindowID = 0;
 	rend = NULL;
 	w = 0;
@@ -61,9 +83,11 @@ Window::Window()
  *               ::SDL_WINDOW_MINIMIZED,     ::SDL_WINDOW_INPUT_GRABBED,
  *               ::SDL_WINDOW_ALLOW_HIGHDPI, ::SDL_WINDOW_VULKAN
  *               ::SDL_WINDOW_METAL.
+ * \param RendererFlags The flags for the renderer, such as ::SDL_RENDERER_SOFTWARE without ::SDL_RENDERER_PRESENTVSYNC for benchmarks.
+ *                      With SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy") before SDL_Init(), no display is needed.
  * \return 1 if succeeded, or 0 if failed.
  */
-bool Window::Init(const char* title, int x, int y, int w, int h, Uint32 flags)
+inline bool Window::Init(const char* title, int x, int y, int w, int h, Uint32 flags, Uint32 RendererFlags)
 {
 	free();
 	//Create a window.
@@ -80,7 +104,7 @@ bool Window::Init(const char* title, int x, int y, int w, int h, Uint32 flags)
 		MouseFocus = true;
 		KeyboardFocus = true;
 		//Create a renderer.
-		rend = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+		rend = SDL_CreateRenderer(window, -1, RendererFlags);
 		if (rend == NULL)
 		{
 			SDL_DestroyWindow(window);
@@ -92,24 +116,230 @@ bool Window::Init(const char* title, int x, int y, int w, int h, Uint32 flags)
 		{
 			SDL_SetRenderDrawColor(rend, 255, 255, 255, 255);
 			WindowID = SDL_GetWindowID(window);
-			shown = true;
+			shown = (flags & SDL_WINDOW_HIDDEN) == 0;
+			minimized = (flags & SDL_WINDOW_MINIMIZED) != 0;
 			return 1;
 		}
 	}
 }
 
+/*
+ * \brief Create an offscreen window, drawn by the software renderer into a surface. No video driver or GPU is needed.
+ * \param w The width of the window.
+ * \param h The height of the window.
+ * \return 1 if succeeded, or 0 if failed.
+ */
+inline bool Window::InitOffscreen(int w, int h)
+{
+	free();
+	surface = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ARGB8888);
+	if (surface == NULL)
+	{
+		SDL_ReportError("SDL_CreateRGBSurfaceWithFormat");
+		return 0;
+	}
+	rend = SDL_CreateSoftwareRenderer(surface);
+	if (rend == NULL)
+	{
+		SDL_FreeSurface(surface);
+		surface = NULL;
+		SDL_ReportError("SDL_CreateSoftwareRenderer");
+		return 0;
+	}
+	this->w = w;
+	this->h = h;
+	SDL_SetRenderDrawColor(rend, 255, 255, 255, 255);
+	shown = true;
+	return 1;
+}
+
+/*
+ * \brief Turn vsync of the renderer on or off, so that measurements aren't capped at the refresh rate.
+ * \param vsync Whether presenting waits for the vertical refresh.
+ * \return 1 if succeeded, or 0 if failed.
+ */
+inline bool Window::SetVSync(bool vsync)
+{
+	if (rend == NULL)
+		return 0;
+	//An offscreen window never waits.
+	if (surface != NULL)
+		return !vsync;
+	if (SDL_RenderSetVSync(rend, vsync) != 0)
+	{
+		SDL_ReportError("SDL_RenderSetVSync");
+		return 0;
+	}
+	return 1;
+}
+
+/*
+ * \brief Read the pixels of the current frame, such as for comparing with golden images. Call it before Present(), since a window may discard the frame when presenting.
+ * \return A new ARGB8888 surface which must be freed with SDL_FreeSurface(), or NULL if failed.
+ */
+inline SDL_Surface* Window::ReadPixels()
+{
+	if (rend == NULL)
+		return NULL;
+	int width, height;
+	if (SDL_GetRendererOutputSize(rend, &width, &height) != 0)
+	{
+		SDL_ReportError("SDL_GetRendererOutputSize");
+		return NULL;
+	}
+	SDL_Surface* pixels = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+	if (pixels == NULL)
+	{
+		SDL_ReportError("SDL_CreateRGBSurfaceWithFormat");
+		return NULL;
+	}
+	if (SDL_RenderReadPixels(rend, NULL, SDL_PIXELFORMAT_ARGB8888, pixels->pixels, pixels->pitch) != 0)
+	{
+		SDL_FreeSurface(pixels);
+		SDL_ReportError("SDL_RenderReadPixels");
+		return NULL;
+	}
+	return pixels;
+}
+
+/*
+ * \brief Save the current frame into a BMP file. Call it before Present().
+ * \param file The path of the BMP file.
+ * \return 1 if succeeded, or 0 if failed.
+ */
+inline bool Window::SaveBMP(const char* file)
+{
+	SDL_Surface* pixels = ReadPixels();
+	if (pixels == NULL)
+		return 0;
+	bool saved = SDL_SaveBMP(pixels, file) == 0;
+	if (!saved)
+		SDL_ReportError("SDL_SaveBMP");
+	SDL_FreeSurface(pixels);
+	return saved;
+}
+
+/*
+ * \brief Create the persistent frame at the output size of the renderer, and mark it dirty.
+ */
+inline bool Window::CreateTarget()
+{
+	if (target != NULL)
+		SDL_DestroyTexture(target);
+	int width, height;
+	if (SDL_GetRendererOutputSize(rend, &width, &height) != 0)
+	{
+		width = w;
+		height = h;
+	}
+	target = SDL_CreateTexture(rend, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, width, height);
+	if (target == NULL)
+	{
+		SDL_ReportError("SDL_CreateTexture");
+		return 0;
+	}
+	dirty.Init(width, height, dirty.GetMaxRects());
+	return 1;
+}
+
+/*
+ * \brief Turn dirty rect rendering on or off. When on, textures of the window's renderer mark the areas they change,
+ * and Redraw() only clears and redraws those areas of a persistent frame.
+ * \param enable Whether only dirty rects are redrawn.
+ * \param MaxRects The largest number of rects redrawn in a frame.
+ * \return 1 if succeeded, or 0 if failed.
+ */
+inline bool Window::EnableDirty(bool enable, int MaxRects)
+{
+	if (rend == NULL)
+		return 0;
+	if (!enable)
+	{
+		SetDirtyRegion(rend, NULL);
+		if (target != NULL)
+			SDL_DestroyTexture(target);
+		target = NULL;
+		dirty.free();
+		return 1;
+	}
+	dirty.Init(0, 0, MaxRects);
+	if (!CreateTarget())
+		return 0;
+	SetDirtyRegion(rend, &dirty);
+	return 1;
+}
+
+/*
+ * \brief Draw a frame and present it. With dirty rects, the drawing function is first called without drawing anything,
+ * to find the textures which moved, appeared or disappeared. Then it is called once for every merged rect
+ * with drawing clipped to it, and nothing is presented if nothing has changed.
+ * \param draw The function drawing the whole scene, such as by calling Show() of every texture.
+ * \return 1 if a frame was presented, or 0 if not.
+ */
+inline bool Window::Redraw(const std::function<void()>& draw)
+{
+	PROFILE_ZONE("Window::Redraw");
+	if (!shown || minimized || rend == NULL)
+		return 0;
+	if (target == NULL)
+	{
+		Clear();
+		draw();
+		Present();
+		return 1;
+	}
+	dirty.StartTracking();
+	draw();
+	dirty.FinishTracking();
+	if (!dirty.IsDirty())
+		return 0;
+	const std::vector<SDL_Rect>& rects = dirty.Merge();
+	//Copies left queued would be drawn on another target or in another rect.
+	FlushRenderQueue(rend);
+	SDL_SetRenderTarget(rend, target);
+	for (int i = 0; i < rects.size(); i++)
+	{
+		FlushRenderQueue(rend);
+		SDL_RenderSetClipRect(rend, &rects[i]);
+		SDL_SetRenderDrawColor(rend, 255, 255, 255, 255);
+		SDL_RenderFillRect(rend, &rects[i]);
+		dirty.SetCurrent(&rects[i]);
+		draw();
+	}
+	dirty.Clear();
+	FlushRenderQueue(rend);
+	SDL_RenderSetClipRect(rend, NULL);
+	SDL_SetRenderTarget(rend, NULL);
+	SDL_RenderCopy(rend, target, NULL, NULL);
+	SDL_RenderPresent(rend);
+	return 1;
+}
+
+/*
+ * \brief Get the dirty region of the window, such as for marking areas drawn without textures.
+ * \return The dirty region.
+ */
+inline DirtyRegion& Window::GetDirty()
+{
+	return dirty;
+}
+
 /*
  * \brief Handle window events.
- * \param event If not NULL, the next event is removed from the queue and stored in that area.
+ * \param event The event to be handled, such as one dispatched by an EventHub.
  */
-void Window::HandleEvent(SDL_Event event)
+inline void Window::HandleEvent(const SDL_Event& event)
 {
+	PROFILE_ZONE("Window::HandleEvent");
 	if (event.type == SDL_WINDOWEVENT && event.window.windowID == WindowID)
 	{
 		switch (event.window.event)
 		{
 			case SDL_WINDOWEVENT_SHOWN:
 				shown = true;
+				//Nothing was drawn while hidden.
+				if (target != NULL)
+					dirty.MarkAll();
 				break;
 			case SDL_WINDOWEVENT_HIDDEN:
 				shown = false;
@@ -117,10 +347,22 @@ void Window::HandleEvent(SDL_Event event)
 			case SDL_WINDOWEVENT_SIZE_CHANGED:
 				w = event.window.data1;
 				h = event.window.data2;
-				SDL_RenderPresent(rend);
+				if (target != NULL)
+					CreateTarget();
+				else
+				{
+					FlushRenderQueue(rend);
+					SDL_RenderPresent(rend);
+				}
 				break;
 			case SDL_WINDOWEVENT_EXPOSED:
-				SDL_RenderPresent(rend);
+				if (target != NULL)
+					dirty.MarkAll();
+				else
+				{
+					FlushRenderQueue(rend);
+					SDL_RenderPresent(rend);
+				}
 				break;
 			case SDL_WINDOWEVENT_ENTER:
 				MouseFocus = true;
@@ -149,7 +391,7 @@ void Window::HandleEvent(SDL_Event event)
 		}
 	}
 	//Press enter to set the window's fullscreen state.
-	else if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_RETURN)
+	else if (window != NULL && event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_RETURN)
 	{
 		if (fullscreened)
 		{
@@ -168,19 +410,24 @@ void Window::HandleEvent(SDL_Event event)
 /*
  * \brief Grab focus to the window.
  */
-void Window::Focus()
+inline void Window::Focus()
 {
+	if (window == NULL)
+		return;
 	if (!shown)
 		SDL_ShowWindow(window);
 	SDL_RaiseWindow(window);
 }
 
 /*
- * \brief Clear the window.
+ * \brief Clear the window, unless it is hidden or minimized.
  */
-void Window::Clear()
+inline void Window::Clear()
 {
-	if (!minimized)
+	PROFILE_ZONE("Window::Clear");
+	//Copies queued before clearing are drawn first, as if they were drawn immediately.
+	FlushRenderQueue(rend);
+	if (shown && !minimized)
 	{
 		SDL_SetRenderDrawColor(rend, 255, 255, 255, 255);
 		SDL_RenderClear(rend);
@@ -188,11 +435,13 @@ void Window::Clear()
 }
 
 /*
- * \brief Present the window.
+ * \brief Present the window, unless it is hidden or minimized.
  */
-void Window::Present()
+inline void Window::Present()
 {
-	if (!minimized)
+	PROFILE_ZONE("Window::Present");
+	FlushRenderQueue(rend);
+	if (shown && !minimized)
 	{
 		SDL_RenderPresent(rend);
 	}
@@ -252,18 +501,51 @@ inline bool Window::IsMinimized()
 	return minimized;
 }
 
+/*
+ * \brief Determine if the window is drawn offscreen.
+ * \return 1 if offscreen, or 0 if not.
+ */
+inline bool Window::IsOffscreen()
+{
+	return surface != NULL;
+}
+
+/*
+ * \brief Get the ID of the window, which events carry as windowID.
+ * \return The ID of the window, or 0 if offscreen or not created.
+ */
+inline Uint32 Window::GetID()
+{
+	return WindowID;
+}
+
+/*
+ * \brief Get the renderer of the window.
+ * \return The renderer, or NULL if not created.
+ */
+inline SDL_Renderer* Window::GetRenderer()
+{
+	return rend;
+}
+
 /*
  * \brief Free the window and its renderer.
  */
-void Window::free()
+inline void Window::free()
 {
-	if (window != NULL)
+	if (window != NULL || surface != NULL)
 	{
 		WindowID = 0;
-		SDL_DestroyWindow(window);
-		window = NULL;
+		EnableDirty(false);
+		//The renderer draws into the window or surface, so it goes first.
 		SDL_DestroyRenderer(rend);
 		rend = NULL;
+		if (window != NULL)
+			SDL_DestroyWindow(window);
+		window = NULL;
+		if (surface != NULL)
+			SDL_FreeSurface(surface);
+		surface = NULL;
 		w = 0;
 		h = 0;
 		MouseFocus = false;
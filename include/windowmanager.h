@@ -0,0 +1,235 @@
+#ifndef windowmanager_h_
+#define windowmanager_h_
+
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <SDL.h>
+#include <window.h>
+#include <texturecache.h>
+#include <eventhub.h>
+#include <profiler.h>
+
+//Window manager wrapper class
+class WindowManager
+{
+private:
+	//Windows in the order they were added, including offscreen ones without IDs.
+	std::vector<Window*> windows;
+	//Windows indexed by their IDs, which SDL hands out counting up from 1.
+	std::vector<Window*> ids;
+	//Texture caches of renderers, shared by everything drawing with the same renderer.
+	std::vector<std::pair<SDL_Renderer*, std::unique_ptr<TextureCache>>> caches;
+	int presented;
+public:
+	WindowManager();
+	~WindowManager();
+	void Add(Window& window);
+	void Remove(Window& window);
+	Window* Get(Uint32 WindowID);
+	int Size();
+	void HandleEvent(const SDL_Event& event);
+	void ClearAll();
+	void PresentAll();
+	int RedrawAll(const std::function<void(Window&)>& draw);
+	bool AnyShown();
+	int GetPresented();
+	TextureCache& GetCache(Window& window);
+	void free();
+};
+
+/*
+ * \brief Create an empty window manager.
+ */
+inline WindowManager::WindowManager()
+{
+	presented = 0;
+}
+
+/*
+ * \brief Deallocate the window manager. The windows themselves are kept.
+ */
+inline WindowManager::~WindowManager()
+{
+	free();
+}
+
+/*
+ * \brief Start managing a created window, which must stay alive until removed.
+ * \param window The window.
+ */
+inline void WindowManager::Add(Window& window)
+{
+	Remove(window);
+	windows.push_back(&window);
+	Uint32 id = window.GetID();
+	if (id == 0)
+		return;
+	if (id >= ids.size())
+		ids.resize(id + 1, NULL);
+	ids[id] = &window;
+}
+
+/*
+ * \brief Stop managing a window, such as before freeing it. The texture cache of its renderer is dropped if no other window uses it.
+ * \param window The window.
+ */
+inline void WindowManager::Remove(Window& window)
+{
+	for (int i = 0; i < windows.size(); i++)
+	{
+		if (windows[i] == &window)
+		{
+			windows.erase(windows.begin() + i);
+			break;
+		}
+	}
+	//The ID may have changed since the window was added, so look for the pointer.
+	for (int i = 0; i < ids.size(); i++)
+		if (ids[i] == &window)
+			ids[i] = NULL;
+	//Drop the texture cache once no managed window draws with its renderer, since the renderer may go away.
+	SDL_Renderer* renderer = window.GetRenderer();
+	for (int i = 0; i < windows.size(); i++)
+		if (windows[i]->GetRenderer() == renderer)
+			return;
+	for (int i = 0; i < caches.size(); i++)
+	{
+		if (caches[i].first == renderer)
+		{
+			caches.erase(caches.begin() + i);
+			break;
+		}
+	}
+}
+
+/*
+ * \brief Find a window by its ID.
+ * \param WindowID The ID of the window, such as the windowID of an event.
+ * \return The window, or NULL if not managed.
+ */
+inline Window* WindowManager::Get(Uint32 WindowID)
+{
+	if (WindowID >= ids.size())
+		return NULL;
+	return ids[WindowID];
+}
+
+/*
+ * \brief Get the number of managed windows.
+ * \return The number of windows.
+ */
+inline int WindowManager::Size()
+{
+	return (int)windows.size();
+}
+
+/*
+ * \brief Hand an event only to the window it happened in, found by its ID.
+ * Events without a window, such as SDL_QUIT, go to no window.
+ * \param event The event, such as one dispatched by an EventHub.
+ */
+inline void WindowManager::HandleEvent(const SDL_Event& event)
+{
+	Window* window = Get(EventWindowID(event));
+	if (window != NULL)
+		window->HandleEvent(event);
+}
+
+/*
+ * \brief Clear every window which is shown and not minimized.
+ */
+inline void WindowManager::ClearAll()
+{
+	for (int i = 0; i < windows.size(); i++)
+		if (windows[i]->IsShown() && !windows[i]->IsMinimized())
+			windows[i]->Clear();
+}
+
+/*
+ * \brief Present every window which is shown and not minimized. Hidden and minimized windows are skipped entirely.
+ */
+inline void WindowManager::PresentAll()
+{
+	PROFILE_ZONE("WindowManager::PresentAll");
+	presented = 0;
+	for (int i = 0; i < windows.size(); i++)
+	{
+		if (windows[i]->IsShown() && !windows[i]->IsMinimized())
+		{
+			windows[i]->Present();
+			presented++;
+		}
+	}
+}
+
+/*
+ * \brief Draw and present every window which is shown and not minimized, through Window::Redraw.
+ * \param draw The function drawing the whole scene of a window.
+ * \return The number of windows presented.
+ */
+inline int WindowManager::RedrawAll(const std::function<void(Window&)>& draw)
+{
+	PROFILE_ZONE("WindowManager::RedrawAll");
+	presented = 0;
+	for (int i = 0; i < windows.size(); i++)
+	{
+		Window& window = *windows[i];
+		if (window.IsShown() && !window.IsMinimized() && window.Redraw([&draw, &window] { draw(window); }))
+			presented++;
+	}
+	return presented;
+}
+
+/*
+ * \brief Determine if any window is still shown, such as for quitting after the last window is closed.
+ * \return 1 if a window is shown, or 0 if not.
+ */
+inline bool WindowManager::AnyShown()
+{
+	for (int i = 0; i < windows.size(); i++)
+		if (windows[i]->IsShown())
+			return 1;
+	return 0;
+}
+
+/*
+ * \brief Get the number of windows presented by the last PresentAll() or RedrawAll().
+ * \return The number of windows.
+ */
+inline int WindowManager::GetPresented()
+{
+	return presented;
+}
+
+/*
+ * \brief Get the texture cache of the renderer of a window. Textures can only be used with the renderer
+ * which created them, so windows drawing with the same renderer share one cache.
+ * \param window The window.
+ * \return The texture cache.
+ */
+inline TextureCache& WindowManager::GetCache(Window& window)
+{
+	SDL_Renderer* renderer = window.GetRenderer();
+	for (int i = 0; i < caches.size(); i++)
+		if (caches[i].first == renderer)
+			return *caches[i].second;
+	caches.push_back({ renderer,std::unique_ptr<TextureCache>(new TextureCache()) });
+	caches.back().second->Init(renderer);
+	return *caches.back().second;
+}
+
+/*
+ * \brief Stop managing all windows and drop the texture caches. Textures still in use stay alive until their last user goes away.
+ */
+inline void WindowManager::free()
+{
+	windows.clear();
+	ids.clear();
+	caches.clear();
+	presented = 0;
+}
+
+
+#endif // !windowmanager_h_
\ No newline at end of file